@@ -0,0 +1,142 @@
+/* Exercises the em2d_c embedding API from plain C.
+ *
+ *   em2d_c_harness [time_domain_config.json]
+ *
+ * Builds a static magnet scene and a time-domain pulse from JSON strings (or the
+ * given config file), reads the fields through zero-copy views and checks the
+ * version/lifetime rules. Exits non-zero if any check fails.
+ */
+#include "em2d_c.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+static int failures = 0;
+
+#define CHECK(cond, what)                                                   \
+    do {                                                                    \
+        if (cond) {                                                         \
+            printf("  ok   %s\n", what);                                    \
+        } else {                                                            \
+            printf("  FAIL %s (line %d)\n", what, __LINE__);                \
+            ++failures;                                                     \
+        }                                                                   \
+    } while (0)
+
+static float at(const em2d_view *v, int x, int y) {
+    const char *p = (const char *)v->data + (int64_t)x * v->stride_x + (int64_t)y * v->stride_y;
+    float value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+static double sumAbs(const em2d_view *v) {
+    double sum = 0.0;
+    for (int y = 0; y < v->height; ++y) {
+        for (int x = 0; x < v->width; ++x) sum += fabs(at(v, x, y));
+    }
+    return sum;
+}
+
+static const char *static_scene =
+    "{ \"grid\": { \"nx\": 96, \"ny\": 64 },"
+    "  \"magnets\": [ { \"x\": 30, \"y\": 32, \"moment_x\": 0.0, \"moment_y\": 1.0, \"strength\": 2.0, \"name\": \"north\" } ] }";
+
+static const char *pulse_scene =
+    "{ \"grid\": { \"nx\": 128, \"ny\": 128, \"dx\": 0.001, \"dy\": 0.001, \"pml_cells\": 8 },"
+    "  \"materials\": [ { \"x0\": 80, \"y0\": 40, \"w\": 20, \"h\": 40, \"eps_r\": 4.0 } ],"
+    "  \"sources\": [ { \"type\": \"gaussian\", \"x\": 48, \"y\": 64, \"amplitude\": 1.0, \"t0\": 30.0, \"spread\": 10.0 } ] }";
+
+static void staticScene(void) {
+    printf("Static magnet scene\n");
+    em2d_sim *sim = em2d_create_from_string(static_scene);
+    CHECK(sim != NULL, "create from string");
+    if (!sim) {
+        printf("       %s\n", em2d_last_error(NULL));
+        return;
+    }
+    CHECK(!em2d_is_time_domain(sim), "scene is static");
+
+    em2d_view ez;
+    CHECK(em2d_field_view(sim, EM2D_FIELD_EZ, &ez) == EM2D_OK, "Ez view");
+    CHECK(ez.width == 96 && ez.height == 64 && ez.dtype == EM2D_DTYPE_FLOAT32, "Ez view shape");
+    CHECK(ez.stride_x == (int64_t)sizeof(float) && ez.stride_y == 96 * (int64_t)sizeof(float), "Ez view strides");
+    CHECK(em2d_view_current(sim, &ez), "fresh view is current");
+    CHECK(fabs(at(&ez, 30, 30)) > fabs(at(&ez, 90, 5)), "field peaks near the magnet");
+
+    /* Every 2nd column and 3rd row from (4, 10): same memory, different strides */
+    em2d_view sub;
+    CHECK(em2d_field_region(sim, EM2D_FIELD_EZ, 4, 10, -1, 8, 2, 3, &sub) == EM2D_OK, "strided region");
+    CHECK(sub.width == 46 && sub.height == 8, "region extent runs to the edge");
+    CHECK(at(&sub, 5, 2) == at(&ez, 4 + 5 * 2, 10 + 2 * 3), "region aliases the full view");
+    CHECK(em2d_field_region(sim, EM2D_FIELD_EZ, 0, 0, 97, 1, 1, 1, &sub) == EM2D_ERROR_ARGUMENT, "oversized region rejected");
+
+    em2d_magnet m;
+    CHECK(em2d_magnet_count(sim) == 1 && em2d_get_magnet(sim, 0, &m) == EM2D_OK && strcmp(m.name, "north") == 0,
+          "read back configured magnet");
+    const float before = at(&ez, 30, 30);
+    const uint64_t version = ez.version;
+    CHECK(em2d_move_magnet(sim, 0, 70, 32) == EM2D_OK, "move magnet");
+    CHECK(em2d_move_magnet(sim, 5, 0, 0) == EM2D_ERROR_ARGUMENT, "moving a missing magnet fails");
+    CHECK(em2d_field_view(sim, EM2D_FIELD_EZ, &ez) == EM2D_OK && ez.version != version, "view after move has a new version");
+    CHECK(fabs(at(&ez, 70, 30)) > fabs(at(&ez, 30, 30)) && at(&ez, 30, 30) != before, "field follows the moved magnet");
+
+    memset(&m, 0, sizeof(m));
+    m.x = 20;
+    m.y = 10;
+    m.moment_x = 1.0;
+    m.strength = 1.5;
+    strcpy(m.name, "added");
+    int32_t index = -1;
+    CHECK(em2d_add_magnet(sim, &m, &index) == EM2D_OK && index == 1 && em2d_magnet_count(sim) == 2, "add magnet");
+    CHECK(em2d_step(sim, 1) == EM2D_OK && !em2d_view_current(sim, &ez), "recompute invalidates older views");
+
+    em2d_destroy(sim);
+}
+
+static void pulseScene(const char *path) {
+    printf("Time-domain scene (%s)\n", path ? path : "built-in pulse");
+    em2d_sim *sim = path ? em2d_create_from_file(path) : em2d_create_from_string(pulse_scene);
+    CHECK(sim != NULL, "create");
+    if (!sim) {
+        printf("       %s\n", em2d_last_error(NULL));
+        return;
+    }
+    CHECK(em2d_is_time_domain(sim), "scene is time-domain");
+
+    em2d_view ez, hx, eps;
+    CHECK(em2d_field_view(sim, EM2D_FIELD_EZ, &ez) == EM2D_OK && sumAbs(&ez) == 0.0, "field starts at zero");
+    CHECK(em2d_step(sim, 60) == EM2D_OK && em2d_current_step(sim) == 60, "advance 60 steps");
+    CHECK(!em2d_view_current(sim, &ez), "stepping invalidates views");
+    CHECK(em2d_field_view(sim, EM2D_FIELD_EZ, &ez) == EM2D_OK && ez.step == 60 && sumAbs(&ez) > 0.0, "pulse is radiating");
+
+    const int hx_status = em2d_field_view(sim, EM2D_FIELD_HX, &hx);
+    if (hx_status == EM2D_ERROR_UNAVAILABLE) {
+        printf("  --   H fields not held in memory for this grid (%s)\n", em2d_last_error(sim));
+    } else {
+        CHECK(hx_status == EM2D_OK && sumAbs(&hx) > 0.0, "Hx view");
+        CHECK(em2d_field_view(sim, EM2D_FIELD_EPS_R, &eps) == EM2D_OK, "eps_r view");
+        if (!path) CHECK(at(&eps, 90, 60) == 4.0f && at(&eps, 10, 10) == 1.0f, "eps_r shows the dielectric block");
+    }
+
+    CHECK(em2d_step(sim, -1) == EM2D_ERROR_ARGUMENT && strlen(em2d_last_error(sim)) > 0, "negative step count rejected");
+    CHECK(em2d_reset(sim) == EM2D_OK && em2d_current_step(sim) == 0, "reset rewinds to step 0");
+    CHECK(em2d_field_view(sim, EM2D_FIELD_EZ, &ez) == EM2D_OK && sumAbs(&ez) == 0.0, "reset clears the field");
+
+    em2d_destroy(sim);
+}
+
+int main(int argc, char **argv) {
+    printf("em2d C API harness (ABI %d)\n", (int)em2d_abi_version());
+    CHECK(em2d_abi_version() == EM2D_ABI_VERSION, "library matches header");
+
+    CHECK(em2d_create_from_string("{ not json") == NULL && strlen(em2d_last_error(NULL)) > 0, "invalid JSON rejected");
+    CHECK(em2d_create_from_file("does/not/exist.json") == NULL, "missing config file rejected");
+
+    staticScene();
+    pulseScene(argc > 1 ? argv[1] : NULL);
+
+    if (failures) printf("%d check(s) failed\n", failures);
+    else printf("All checks passed\n");
+    return failures ? 1 : 0;
+}
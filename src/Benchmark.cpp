@@ -0,0 +1,154 @@
+#include "Benchmark.hpp"
+#include "Config.hpp"
+#include "FDTD.hpp"
+#include "PinnedPool.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+namespace {
+
+struct KernelRun {
+    SolverPrecision precision;
+    SolverKernel kernel;
+    double seconds = 0.0;
+    double mcells_per_s = 0.0;
+    std::vector<float> ez;
+};
+
+void runOnce(const Config &cfg, int steps, KernelRun &run) {
+    GridConfig grid = cfg.grid;
+    grid.solver.precision = solverPrecisionName(run.precision);
+    grid.solver.kernel = solverKernelName(run.kernel);
+    FDTD sim(grid);
+    for (const auto &m : cfg.materials) sim.addMaterialBlock(m.x0, m.y0, m.w, m.h, m.eps_r);
+    for (const auto &s : cfg.sources) sim.addSource(s);
+    for (const auto &m : cfg.magnets) sim.addMagnet(m);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    if (sim.isTimeDomain()) sim.advance(steps);
+    else sim.step();
+    run.seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+    const double cells = static_cast<double>(sim.meshWidth()) * sim.meshHeight() * (sim.isTimeDomain() ? steps : 1);
+    run.mcells_per_s = cells / 1e6 / std::max(run.seconds, 1e-9);
+    run.ez = sim.getEz();
+}
+
+// a = b + s*c over pool-placed arrays; best of `repeats`, counting the three streams only
+double triadBandwidth(PinnedPool &pool, size_t n, int repeats) {
+    const int rows = pool.size() * 64;
+    const size_t row = n / rows;
+    n = row * rows;
+    std::vector<float> a(n), b(n), c(n);
+    pool.firstTouch(a, rows, 0.0f);
+    pool.firstTouch(b, rows, 1.0f);
+    pool.firstTouch(c, rows, 2.0f);
+    float *pa = a.data();
+    const float *pb = b.data(), *pc = c.data();
+    double best = 1e30;
+    for (int r = 0; r < repeats; ++r) {
+        auto start = std::chrono::high_resolution_clock::now();
+        pool.forRows(rows, 0, rows, [=](int j) {
+            const size_t base = static_cast<size_t>(j) * row;
+            for (size_t i = base; i < base + row; ++i) pa[i] = pb[i] + 3.0f * pc[i];
+        });
+        best = std::min(best, std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count());
+    }
+    return 3.0 * n * sizeof(float) / 1e9 / std::max(best, 1e-9);
+}
+
+}
+
+int runKernelBenchmark(const std::string &config_path, int steps) {
+    auto cfg = Config::loadFromFile(config_path);
+    if (!cfg) return 1;
+    if (cfg->grid.adaptive.enabled || cfg->grid.out_of_core.enabled) {
+        std::cout << "Kernel benchmark needs an in-memory grid - adaptive and out-of-core scenes use their own kernels" << std::endl;
+        return 1;
+    }
+    cfg->grid.decomposition.ranks = 1;
+    steps = std::max(steps, 1);
+    const bool time_domain = !cfg->sources.empty();
+
+    // Double/threaded first: it is the reference and warms up the thread pool
+    std::vector<KernelRun> runs;
+    for (SolverPrecision p : {SolverPrecision::Double, SolverPrecision::Float, SolverPrecision::Half}) {
+        for (SolverKernel k : {SolverKernel::Threaded, SolverKernel::Pinned, SolverKernel::Simd, SolverKernel::Scalar}) {
+            runs.push_back({p, k, 0.0, 0.0, {}});
+        }
+    }
+    for (auto &run : runs) {
+        std::cout << "=== " << solverPrecisionName(run.precision) << "/" << solverKernelName(run.kernel) << " ===" << std::endl;
+        runOnce(*cfg, steps, run);
+    }
+
+    const std::vector<float> &ref = runs.front().ez;
+    float ref_peak = 0.0f;
+    for (float v : ref) ref_peak = std::max(ref_peak, std::abs(v));
+
+    std::cout << std::endl << "?? Kernel benchmark: " << cfg->scenario << " (" << cfg->grid.nx << "x" << cfg->grid.ny << ", "
+              << (time_domain ? std::to_string(steps) + " steps" : std::string("static field")) << ")" << std::endl;
+    std::cout << std::left << std::setw(11) << "precision" << std::setw(10) << "kernel" << std::right
+              << std::setw(12) << "bytes/cell" << std::setw(11) << "time [s]" << std::setw(11) << "Mcells/s"
+              << std::setw(13) << "max |dEz|" << std::setw(11) << "rel" << std::endl;
+    for (const auto &run : runs) {
+        float max_err = 0.0f;
+        for (size_t i = 0; i < std::min(ref.size(), run.ez.size()); ++i) max_err = std::max(max_err, std::abs(run.ez[i] - ref[i]));
+        const int bytes = 3 * (run.precision == SolverPrecision::Double ? 8 : run.precision == SolverPrecision::Half ? 2 : 4);
+        std::cout << std::left << std::setw(11) << solverPrecisionName(run.precision) << std::setw(10) << solverKernelName(run.kernel)
+                  << std::right << std::setw(12) << (time_domain ? std::to_string(bytes) : std::string("-"))
+                  << std::fixed << std::setprecision(3) << std::setw(11) << run.seconds
+                  << std::setprecision(1) << std::setw(11) << run.mcells_per_s
+                  << std::scientific << std::setprecision(2) << std::setw(13) << max_err
+                  << std::setw(11) << (ref_peak > 0.0f ? max_err / ref_peak : 0.0f) << std::defaultfloat << std::endl;
+    }
+    return 0;
+}
+
+int runNumaBenchmark(const std::string &config_path, int steps) {
+    auto cfg = Config::loadFromFile(config_path);
+    if (!cfg) return 1;
+    if (cfg->grid.adaptive.enabled || cfg->grid.out_of_core.enabled) {
+        std::cout << "NUMA benchmark needs an in-memory grid - adaptive and out-of-core scenes use their own kernels" << std::endl;
+        return 1;
+    }
+    cfg->grid.decomposition.ranks = 1;
+    steps = std::max(steps, 1);
+
+    const NumaTopology topo = NumaTopology::detect();
+    std::cout << "NUMA topology: " << topo.describe() << std::endl;
+    std::vector<int> node_counts = {1};
+    if (topo.nodes() > 1) node_counts.push_back(topo.nodes());
+
+    struct NumaRun { int nodes, threads; double triad_gbs; KernelRun pinned; };
+    std::vector<NumaRun> results;
+    for (int nodes : node_counts) {
+        std::cout << "=== " << nodes << (nodes == 1 ? " node" : " nodes") << " ===" << std::endl;
+        cfg->grid.solver.numa_nodes = nodes;
+        PinnedPool::configure({cfg->grid.solver.threads, nodes, cfg->grid.solver.huge_pages});
+        NumaRun r{nodes, PinnedPool::shared().size(), 0.0, {SolverPrecision::Float, SolverKernel::Pinned, 0.0, 0.0, {}}};
+        r.triad_gbs = triadBandwidth(PinnedPool::shared(), size_t(1) << 24, 5);
+        runOnce(*cfg, steps, r.pinned);
+        results.push_back(std::move(r));
+    }
+    // Unpinned reference: the TBB-backed scheduler with pages wherever the constructor zeroed them
+    KernelRun threaded{SolverPrecision::Float, SolverKernel::Threaded, 0.0, 0.0, {}};
+    std::cout << "=== threaded (unpinned) ===" << std::endl;
+    runOnce(*cfg, steps, threaded);
+
+    std::cout << std::endl << "?? NUMA benchmark: " << cfg->scenario << " (" << cfg->grid.nx << "x" << cfg->grid.ny << ", "
+              << (cfg->sources.empty() ? std::string("static field") : std::to_string(steps) + " steps") << ")" << std::endl;
+    std::cout << std::left << std::setw(8) << "nodes" << std::right << std::setw(9) << "threads"
+              << std::setw(14) << "triad GB/s" << std::setw(18) << "pinned Mcells/s" << std::setw(20) << "threaded Mcells/s" << std::endl;
+    for (const auto &r : results) {
+        std::cout << std::left << std::setw(8) << r.nodes << std::right << std::setw(9) << r.threads << std::fixed
+                  << std::setprecision(2) << std::setw(14) << r.triad_gbs << std::setprecision(1) << std::setw(18)
+                  << r.pinned.mcells_per_s << std::setw(20) << threaded.mcells_per_s << std::defaultfloat << std::endl;
+    }
+    if (topo.nodes() == 1) std::cout << "Only one NUMA node visible to this process - the multi-socket row is skipped" << std::endl;
+    return 0;
+}
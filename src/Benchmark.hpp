@@ -0,0 +1,14 @@
+#pragma once
+
+#include <string>
+
+// em2d --bench-kernels [config.json] [steps]: runs the scene once per <precision, kernel>
+// combination of grid.solver and prints throughput and the deviation of Ez from the
+// double-precision threaded result. Time-domain scenes advance `steps` steps; static
+// scenes time one evaluation of the magnet field.
+int runKernelBenchmark(const std::string &config_path, int steps);
+
+// em2d --bench-numa [config.json] [steps]: for one NUMA node and for all of them, places a
+// STREAM-style triad and the scene's float fields with the pinned pool, then prints triad
+// bandwidth and solver throughput of the pinned kernel next to the unpinned threaded one.
+int runNumaBenchmark(const std::string &config_path, int steps);
@@ -0,0 +1,198 @@
+#include "CPML.hpp"
+#include "SolverPolicy.hpp"
+#include <cmath>
+#include <algorithm>
+#include <iostream>
+
+// Same physical constants as the FDTD kernels
+namespace {
+const double mu0_cpml = 4.0*3.14159265358979323846*1e-7;
+const double c0_cpml = 3e8;
+const double eps0_cpml = 1.0/(mu0_cpml*c0_cpml*c0_cpml);
+const double eta0_cpml = mu0_cpml*c0_cpml;
+}
+
+CPML::CPML(const MeshAxis &ax, const MeshAxis &ay, double dt, const GridConfig &grid,
+           const CPMLLayout &layout)
+: nx(ax.size()), ny(ay.size()), sides(layout) {
+    // Keep at least two interior cells between opposite layers
+    npml = std::clamp(grid.pml_cells, 0, std::max(0, (std::min(nx, ny) - 4) / 2));
+    if (npml == 0) return;
+    if (sides.ez_i1 < 0) sides.ez_i1 = nx - 1;
+    if (sides.ez_j1 < 0) sides.ez_j1 = ny - 1;
+
+    c0dt = static_cast<float>(c0_cpml * dt);
+    inv_dn_x = ax.invNodeSpacing(); inv_dc_x = ax.invCellWidth();
+    inv_dn_y = ay.invNodeSpacing(); inv_dc_y = ay.invCellWidth();
+
+    // Conductivity is graded against the spacing of the outermost cells
+    const double dx = 1.0 / inv_dn_x[0];
+    const double dy = 1.0 / inv_dn_y[0];
+    buildProfile(nx, dx, dt, grid, sides.x_lo, sides.x_hi, be_x, ce_x, bh_x, ch_x);
+    buildProfile(ny, dy, dt, grid, sides.y_lo, sides.y_hi, be_y, ce_y, bh_y, ch_y);
+
+    // Auxiliary fields exist only inside the boundary strips that carry a layer
+    const size_t strip_x = static_cast<size_t>(npml) * ny;
+    const size_t strip_y = static_cast<size_t>(npml) * nx;
+    if (sides.x_lo) { psi_Hy_xlo.assign(strip_x, 0.0f); psi_Ez_xlo.assign(strip_x, 0.0f); }
+    if (sides.x_hi) { psi_Hy_xhi.assign(strip_x, 0.0f); psi_Ez_xhi.assign(strip_x, 0.0f); }
+    if (sides.y_lo) { psi_Hx_ylo.assign(strip_y, 0.0f); psi_Ez_ylo.assign(strip_y, 0.0f); }
+    if (sides.y_hi) { psi_Hx_yhi.assign(strip_y, 0.0f); psi_Ez_yhi.assign(strip_y, 0.0f); }
+
+    std::cout << "CPML boundary: " << npml << " cells, order " << grid.pml_order
+              << ", strip memory " << (memoryBytes() / 1024) << " KB" << std::endl;
+}
+
+void CPML::buildProfile(int n, double d, double dt, const GridConfig &grid, bool lo_side, bool hi_side,
+                        std::vector<float> &be, std::vector<float> &ce,
+                        std::vector<float> &bh, std::vector<float> &ch) const {
+    const double m = grid.pml_order;
+    const double sigma_max = 0.8 * (m + 1.0) / (eta0_cpml * d);
+    const double alpha_max = grid.pml_alpha_max;
+    const double inner_hi = static_cast<double>(n - 1 - npml);
+
+    // Normalized depth into the layer: 0 at the interface, 1 at the outer wall
+    auto depth = [&](double x) {
+        double lo = lo_side ? (npml - x) / npml : 0.0;
+        double hi = hi_side ? (x - inner_hi) / npml : 0.0;
+        return std::clamp(std::max(lo, hi), 0.0, 1.0);
+    };
+    auto coeffs = [&](double rho, float &b, float &c) {
+        const double sigma = sigma_max * std::pow(rho, m);
+        const double alpha = alpha_max * (1.0 - rho);
+        const double bb = std::exp(-(sigma + alpha) * dt / eps0_cpml);
+        b = static_cast<float>(bb);
+        c = sigma > 0.0 ? static_cast<float>(sigma / (sigma + alpha) * (bb - 1.0)) : 0.0f;
+    };
+
+    be.assign(n, 0.0f); ce.assign(n, 0.0f);
+    bh.assign(n, 0.0f); ch.assign(n, 0.0f);
+    for (int i = 0; i < n; ++i) {
+        coeffs(depth(i), be[i], ce[i]);         // E nodes at integer positions
+        coeffs(depth(i + 0.5), bh[i], ch[i]);   // H nodes at half-integer positions
+    }
+}
+
+void CPML::reset() {
+    for (auto *psi : {&psi_Hy_xlo, &psi_Hy_xhi, &psi_Ez_xlo, &psi_Ez_xhi,
+                      &psi_Hx_ylo, &psi_Hx_yhi, &psi_Ez_ylo, &psi_Ez_yhi}) {
+        std::fill(psi->begin(), psi->end(), 0.0f);
+    }
+}
+
+std::vector<const std::vector<float>*> CPML::auxiliaryFields() const {
+    return {&psi_Hy_xlo, &psi_Hy_xhi, &psi_Ez_xlo, &psi_Ez_xhi,
+            &psi_Hx_ylo, &psi_Hx_yhi, &psi_Ez_ylo, &psi_Ez_yhi};
+}
+
+std::vector<std::vector<float>*> CPML::auxiliaryFields() {
+    return {&psi_Hy_xlo, &psi_Hy_xhi, &psi_Ez_xlo, &psi_Ez_xhi,
+            &psi_Hx_ylo, &psi_Hx_yhi, &psi_Ez_ylo, &psi_Ez_yhi};
+}
+
+template <typename Real>
+void CPML::correctH(const Real *Ez, Real *Hx, Real *Hy) {
+    using T = precision::Traits<Real>;
+    using Acc = typename T::Acc;
+    if (npml == 0) return;
+    const int hi_x = nx - 1 - npml;
+    const int hi_y = ny - 1 - npml;
+
+    // x strips: dEz/dx term of Hy, contiguous npml-wide runs per row
+    for (int side = 0; side < 2; ++side) {
+        std::vector<float> &strip = side == 0 ? psi_Hy_xlo : psi_Hy_xhi;
+        if (strip.empty()) continue;
+        const int i0 = side == 0 ? 0 : hi_x;
+        for (int j = 0; j < ny; ++j) {
+            const Real *ez = &Ez[static_cast<size_t>(j) * nx];
+            Real *hy = &Hy[static_cast<size_t>(j) * nx];
+            float *psi = &strip[static_cast<size_t>(j) * npml];
+            for (int k = 0; k < npml; ++k) {
+                const int i = i0 + k;
+                psi[k] = bh_x[i] * psi[k] + ch_x[i] * static_cast<float>(T::load(ez[i+1]) - T::load(ez[i])) * inv_dn_x[i];
+                hy[i] = T::store(T::load(hy[i]) + static_cast<Acc>(c0dt) * static_cast<Acc>(psi[k]));
+            }
+        }
+    }
+
+    // y strips: dEz/dy term of Hx, full contiguous rows
+    for (int side = 0; side < 2; ++side) {
+        std::vector<float> &strip = side == 0 ? psi_Hx_ylo : psi_Hx_yhi;
+        if (strip.empty()) continue;
+        for (int k = 0; k < npml; ++k) {
+            const int j = side == 0 ? k : hi_y + k;
+            const float b = bh_y[j], c = ch_y[j] * inv_dn_y[j];
+            const Real *ez0 = &Ez[static_cast<size_t>(j) * nx];
+            const Real *ez1 = ez0 + nx;
+            Real *hx = &Hx[static_cast<size_t>(j) * nx];
+            float *psi = &strip[static_cast<size_t>(k) * nx];
+            for (int i = 0; i < nx; ++i) {
+                psi[i] = b * psi[i] + c * static_cast<float>(T::load(ez1[i]) - T::load(ez0[i]));
+                hx[i] = T::store(T::load(hx[i]) - static_cast<Acc>(c0dt) * static_cast<Acc>(psi[i]));
+            }
+        }
+    }
+}
+
+template <typename Real>
+void CPML::correctE(const Real *Hx, const Real *Hy, Real *Ez, const float *cez) {
+    using T = precision::Traits<Real>;
+    using Acc = typename T::Acc;
+    if (npml == 0) return;
+    const int hi_x = nx - 1 - npml;
+    const int hi_y = ny - 1 - npml;
+
+    // x strips: dHy/dx term (outer PEC wall at i = 0 and i = nx-1 is never updated)
+    for (int side = 0; side < 2; ++side) {
+        std::vector<float> &strip = side == 0 ? psi_Ez_xlo : psi_Ez_xhi;
+        if (strip.empty()) continue;
+        const int i0 = side == 0 ? 0 : hi_x;
+        const int k0 = side == 0 ? 1 : 0;
+        for (int j = sides.ez_j0; j < sides.ez_j1; ++j) {
+            const size_t row = static_cast<size_t>(j) * nx;
+            const Real *hy = &Hy[row];
+            const float *ce = &cez[row];
+            Real *ez = &Ez[row];
+            float *psi = &strip[static_cast<size_t>(j) * npml];
+            for (int k = k0; k < npml; ++k) {
+                const int i = i0 + k;
+                psi[k] = be_x[i] * psi[k] + ce_x[i] * static_cast<float>(T::load(hy[i]) - T::load(hy[i-1])) * inv_dc_x[i];
+                ez[i] = T::store(T::load(ez[i]) + static_cast<Acc>(ce[i]) * static_cast<Acc>(psi[k]));
+            }
+        }
+    }
+
+    // y strips: dHx/dy term
+    for (int side = 0; side < 2; ++side) {
+        std::vector<float> &strip = side == 0 ? psi_Ez_ylo : psi_Ez_yhi;
+        if (strip.empty()) continue;
+        for (int k = 0; k < npml; ++k) {
+            const int j = side == 0 ? k : hi_y + k;
+            if (j < 1) continue;
+            const float b = be_y[j], c = ce_y[j] * inv_dc_y[j];
+            const size_t row = static_cast<size_t>(j) * nx;
+            const Real *hx1 = &Hx[row];
+            const Real *hx0 = hx1 - nx;
+            const float *ce = &cez[row];
+            Real *ez = &Ez[row];
+            float *psi = &strip[static_cast<size_t>(k) * nx];
+            for (int i = sides.ez_i0; i < sides.ez_i1; ++i) {
+                psi[i] = b * psi[i] + c * static_cast<float>(T::load(hx1[i]) - T::load(hx0[i]));
+                ez[i] = T::store(T::load(ez[i]) - static_cast<Acc>(ce[i]) * static_cast<Acc>(psi[i]));
+            }
+        }
+    }
+}
+
+template void CPML::correctH<float>(const float*, float*, float*);
+template void CPML::correctH<double>(const double*, double*, double*);
+template void CPML::correctH<Half>(const Half*, Half*, Half*);
+template void CPML::correctE<float>(const float*, const float*, float*, const float*);
+template void CPML::correctE<double>(const double*, const double*, double*, const float*);
+template void CPML::correctE<Half>(const Half*, const Half*, Half*, const float*);
+
+size_t CPML::memoryBytes() const {
+    size_t n = psi_Hy_xlo.size() + psi_Hy_xhi.size() + psi_Ez_xlo.size() + psi_Ez_xhi.size()
+             + psi_Hx_ylo.size() + psi_Hx_yhi.size() + psi_Ez_ylo.size() + psi_Ez_yhi.size();
+    return n * sizeof(float);
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <vector>
+#include "Config.hpp"
+#include "Mesh.hpp"
+
+// Which domain sides carry an absorbing layer, and the Ez column/row range the
+// solver updates (symmetry planes and periodic seams replace the PML on their side)
+struct CPMLLayout {
+    bool x_lo = true, x_hi = true, y_lo = true, y_hi = true;
+    int ez_i0 = 1, ez_i1 = -1;   // Updated Ez columns [ez_i0, ez_i1); -1 means nx-1
+    int ez_j0 = 1, ez_j1 = -1;   // Updated Ez rows [ez_j0, ez_j1); -1 means ny-1
+};
+
+// Convolutional Perfectly Matched Layer (CPML) absorbing boundary
+// Auxiliary psi fields are stored only for the four boundary strips and are
+// applied as a separate correction pass after the branch-free interior update.
+// Fields use the normalized form H' = eta0*H, matching the FDTD kernels.
+class CPML {
+public:
+    CPML() = default;
+    CPML(const MeshAxis &ax, const MeshAxis &ay, double dt, const GridConfig &grid,
+         const CPMLLayout &layout = CPMLLayout{});
+
+    bool enabled() const { return npml > 0; }
+    int thickness() const { return npml; }
+    void reset();
+
+    // Called right after the interior H / E updates of the same time step, on nx*ny fields in
+    // the solver's storage type (float, double or Half; the psi strips themselves stay fp32)
+    template <typename Real> void correctH(const Real *Ez, Real *Hx, Real *Hy);
+    template <typename Real> void correctE(const Real *Hx, const Real *Hy, Real *Ez, const float *cez);
+
+    size_t memoryBytes() const;
+
+    // Auxiliary psi strips in a fixed order, for checkpoint/restart
+    std::vector<const std::vector<float>*> auxiliaryFields() const;
+    std::vector<std::vector<float>*> auxiliaryFields();
+
+private:
+    int nx = 0, ny = 0;
+    int npml = 0;
+    CPMLLayout sides;
+    float c0dt = 0.0f;
+
+    // Per-node inverse spacings copied from the mesh axes (uniform grids hold constants)
+    std::vector<float> inv_dn_x, inv_dc_x, inv_dn_y, inv_dc_y;
+
+    // 1-D recursive convolution coefficients along each axis (E nodes and H half-nodes)
+    std::vector<float> be_x, ce_x, bh_x, ch_x;
+    std::vector<float> be_y, ce_y, bh_y, ch_y;
+
+    // Strip-local auxiliary fields: x strips are npml wide (ny rows), y strips npml tall (nx columns)
+    std::vector<float> psi_Hy_xlo, psi_Hy_xhi, psi_Ez_xlo, psi_Ez_xhi;
+    std::vector<float> psi_Hx_ylo, psi_Hx_yhi, psi_Ez_ylo, psi_Ez_yhi;
+
+    void buildProfile(int n, double d, double dt, const GridConfig &grid, bool lo, bool hi,
+                      std::vector<float> &be, std::vector<float> &ce,
+                      std::vector<float> &bh, std::vector<float> &ch) const;
+};
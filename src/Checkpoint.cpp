@@ -0,0 +1,305 @@
+#include "Checkpoint.hpp"
+#include "Codec.hpp"
+#include "FDTD.hpp"
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace {
+const char magic[8] = {'E', 'M', '2', 'D', 'C', 'K', 'P', 'T'};
+
+enum Encoding : uint8_t { Raw = 0, ShuffleRLE = 1 };
+
+std::array<uint32_t, 256> makeCrcTable() {
+    std::array<uint32_t, 256> table{};
+    for (uint32_t n = 0; n < 256; ++n) {
+        uint32_t c = n;
+        for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        table[n] = c;
+    }
+    return table;
+}
+
+template <typename T>
+void put(std::vector<uint8_t> &buf, T value) {
+    const uint8_t *p = reinterpret_cast<const uint8_t*>(&value);
+    buf.insert(buf.end(), p, p + sizeof(T));
+}
+
+template <typename T>
+bool get(std::ifstream &ifs, T &value) {
+    return static_cast<bool>(ifs.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+}
+
+size_t FieldSnapshot::bytes() const {
+    size_t total = 0;
+    for (const auto &s : sections) total += s.data.size() * sizeof(float);
+    return total;
+}
+
+namespace checkpoint {
+
+uint32_t crc32(const void *data, size_t bytes, uint32_t crc) {
+    static const std::array<uint32_t, 256> table = makeCrcTable();
+    const uint8_t *p = static_cast<const uint8_t*>(data);
+    crc = ~crc;
+    for (size_t k = 0; k < bytes; ++k) crc = table[(crc ^ p[k]) & 0xff] ^ (crc >> 8);
+    return ~crc;
+}
+
+uint64_t fnv1a(const void *data, size_t bytes, uint64_t hash) {
+    const uint8_t *p = static_cast<const uint8_t*>(data);
+    for (size_t k = 0; k < bytes; ++k) {
+        hash ^= p[k];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+bool write(const std::string &path, const FieldSnapshot &snap, bool compress, size_t *stored_bytes) {
+    const std::string tmp = path + ".tmp";
+    std::ofstream ofs(tmp, std::ios::binary | std::ios::trunc);
+    if (!ofs) {
+        std::cerr << "Could not create checkpoint file: " << tmp << "\n";
+        return false;
+    }
+
+    std::vector<uint8_t> header(magic, magic + sizeof(magic));
+    put<uint32_t>(header, version);
+    put<uint32_t>(header, static_cast<uint32_t>(snap.sections.size()));
+    put<int32_t>(header, snap.nx);
+    put<int32_t>(header, snap.ny);
+    put<int64_t>(header, snap.step);
+    put<uint64_t>(header, snap.fingerprint);
+    put<uint32_t>(header, crc32(header.data(), header.size()));
+    ofs.write(reinterpret_cast<const char*>(header.data()), header.size());
+    size_t total = header.size();
+
+    std::vector<uint8_t> shuffled, encoded, meta;
+    for (const auto &s : snap.sections) {
+        const size_t raw_bytes = s.data.size() * sizeof(float);
+        const uint8_t *payload = reinterpret_cast<const uint8_t*>(s.data.data());
+        size_t payload_bytes = raw_bytes;
+        uint8_t encoding = Raw;
+        if (compress && !s.data.empty()) {
+            codec::shuffle(s.data.data(), s.data.size(), sizeof(float), shuffled);
+            codec::rleEncode(shuffled.data(), shuffled.size(), encoded);
+            if (encoded.size() < raw_bytes) {
+                encoding = ShuffleRLE;
+                payload = encoded.data();
+                payload_bytes = encoded.size();
+            }
+        }
+
+        meta.clear();
+        put<uint16_t>(meta, static_cast<uint16_t>(s.name.size()));
+        meta.insert(meta.end(), s.name.begin(), s.name.end());
+        put<uint8_t>(meta, encoding);
+        put<uint64_t>(meta, s.data.size());
+        put<uint64_t>(meta, payload_bytes);
+        put<uint32_t>(meta, crc32(s.data.data(), raw_bytes));
+        ofs.write(reinterpret_cast<const char*>(meta.data()), meta.size());
+        ofs.write(reinterpret_cast<const char*>(payload), payload_bytes);
+        total += meta.size() + payload_bytes;
+    }
+    ofs.close();
+    if (!ofs) {
+        std::cerr << "Failed writing checkpoint file: " << tmp << "\n";
+        std::remove(tmp.c_str());
+        return false;
+    }
+    if (std::rename(tmp.c_str(), path.c_str()) != 0) {
+        // Windows rename() does not replace an existing file
+        std::remove(path.c_str());
+        if (std::rename(tmp.c_str(), path.c_str()) != 0) {
+            std::cerr << "Could not move checkpoint into place: " << path << "\n";
+            return false;
+        }
+    }
+    if (stored_bytes) *stored_bytes = total;
+    return true;
+}
+
+std::optional<FieldSnapshot> read(const std::string &path) {
+    std::ifstream ifs(path, std::ios::binary);
+    if (!ifs) {
+        std::cerr << "Could not open checkpoint file: " << path << "\n";
+        return std::nullopt;
+    }
+
+    char file_magic[8];
+    uint32_t file_version = 0, count = 0, header_crc = 0;
+    int32_t nx = 0, ny = 0;
+    int64_t step = 0;
+    uint64_t fingerprint = 0;
+    if (!ifs.read(file_magic, sizeof(file_magic)) || std::memcmp(file_magic, magic, sizeof(magic)) != 0) {
+        std::cerr << "Not an EM2D checkpoint: " << path << "\n";
+        return std::nullopt;
+    }
+    if (!get(ifs, file_version) || !get(ifs, count) || !get(ifs, nx) || !get(ifs, ny) ||
+        !get(ifs, step) || !get(ifs, fingerprint) || !get(ifs, header_crc)) {
+        std::cerr << "Truncated checkpoint header: " << path << "\n";
+        return std::nullopt;
+    }
+    if (file_version != version) {
+        std::cerr << "Unsupported checkpoint version " << file_version << " (expected " << version << ")\n";
+        return std::nullopt;
+    }
+    std::vector<uint8_t> header(magic, magic + sizeof(magic));
+    put(header, file_version);
+    put(header, count);
+    put(header, nx);
+    put(header, ny);
+    put(header, step);
+    put(header, fingerprint);
+    if (crc32(header.data(), header.size()) != header_crc) {
+        std::cerr << "Checkpoint header checksum mismatch: " << path << "\n";
+        return std::nullopt;
+    }
+
+    FieldSnapshot snap;
+    snap.nx = nx;
+    snap.ny = ny;
+    snap.step = step;
+    snap.fingerprint = fingerprint;
+    std::vector<uint8_t> payload, decoded;
+    for (uint32_t k = 0; k < count; ++k) {
+        uint16_t name_len = 0;
+        uint8_t encoding = 0;
+        uint64_t floats = 0, stored = 0;
+        uint32_t crc = 0;
+        CheckpointSection section;
+        if (!get(ifs, name_len)) return std::nullopt;
+        section.name.resize(name_len);
+        if (!ifs.read(section.name.data(), name_len) || !get(ifs, encoding) || !get(ifs, floats) ||
+            !get(ifs, stored) || !get(ifs, crc) || stored > (floats + 1) * 2 * sizeof(float)) {
+            std::cerr << "Corrupt checkpoint section " << k << " in " << path << "\n";
+            return std::nullopt;
+        }
+        section.data.resize(floats);
+        const size_t raw_bytes = floats * sizeof(float);
+        bool ok = false;
+        if (encoding == Raw && stored == raw_bytes) {
+            ok = static_cast<bool>(ifs.read(reinterpret_cast<char*>(section.data.data()), raw_bytes));
+        } else if (encoding == ShuffleRLE) {
+            payload.resize(stored);
+            ok = ifs.read(reinterpret_cast<char*>(payload.data()), stored) &&
+                 codec::rleDecode(payload.data(), payload.size(), decoded, raw_bytes);
+            if (ok) codec::unshuffle(decoded.data(), floats, sizeof(float), section.data.data());
+        }
+        if (!ok || crc32(section.data.data(), raw_bytes) != crc) {
+            std::cerr << "Checkpoint section '" << section.name << "' failed its checksum: " << path << "\n";
+            return std::nullopt;
+        }
+        snap.sections.push_back(std::move(section));
+    }
+    return snap;
+}
+
+}
+
+Checkpointer::Checkpointer(const CheckpointConfig &conf_) : conf(conf_) {
+    if (!enabled()) return;
+    std::cout << "Checkpoints every " << conf.interval << " steps to " << conf.path
+              << (conf.compress ? " (compressed)" : "") << std::endl;
+    writer = std::thread([this] { writerLoop(); });
+}
+
+Checkpointer::~Checkpointer() {
+    {
+        std::lock_guard<std::mutex> lock(m);
+        quit = true;
+    }
+    cv.notify_all();
+    if (writer.joinable()) writer.join();
+}
+
+void Checkpointer::maybeSave(const FDTD &sim) {
+    if (!enabled() || !sim.isTimeDomain()) return;
+    const long long step = sim.getStep();
+    // Checkpoints land on multiples of the interval, also after a restart or a deferral
+    if (next_step < 0) next_step = (step / conf.interval + 1) * conf.interval;
+    if (step < next_step) return;
+    {
+        std::lock_guard<std::mutex> lock(m);
+        if (busy) {
+            ++deferred;  // Retry on the next call rather than wait for the disk
+            return;
+        }
+    }
+
+    // The writer is idle, so the staging buffer is ours until busy is set
+    auto start = std::chrono::high_resolution_clock::now();
+    if (!sim.snapshot(staging)) {
+        std::cout << "Checkpointing is not supported in this solver mode - disabled" << std::endl;
+        conf.interval = 0;
+        return;
+    }
+    snapshot_s += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+    ++snapshots;
+    next_step = (step / conf.interval + 1) * conf.interval;
+    {
+        std::lock_guard<std::mutex> lock(m);
+        busy = true;
+    }
+    cv.notify_all();
+}
+
+void Checkpointer::restart() {
+    if (!enabled()) return;
+    // A write still in flight belongs to the old scene; let it land before its step is forgotten
+    std::unique_lock<std::mutex> lock(m);
+    cv.wait(lock, [this] { return !busy; });
+    next_step = -1;
+    saved_step = -1;
+}
+
+void Checkpointer::finish(const FDTD &sim) {
+    if (!enabled()) return;
+    {
+        std::unique_lock<std::mutex> lock(m);
+        cv.wait(lock, [this] { return !busy; });
+    }
+    if (sim.isTimeDomain() && sim.getStep() != saved_step && sim.snapshot(staging)) {
+        if (checkpoint::write(conf.path, staging, conf.compress)) {
+            ++written;
+            std::cout << "Final checkpoint at step " << staging.step << " written to " << conf.path << std::endl;
+        }
+    }
+    std::cout << "?? Checkpoints: " << written << " written, " << deferred << " deferred while the writer was busy";
+    if (snapshots > 0) std::cout << ", snapshot copy " << (1000.0 * snapshot_s / snapshots) << "ms avg, background write "
+                                 << (1000.0 * write_s / snapshots) << "ms avg";
+    std::cout << std::endl;
+}
+
+void Checkpointer::writerLoop() {
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(m);
+            cv.wait(lock, [this] { return busy || quit; });
+            if (!busy) return;
+        }
+        auto start = std::chrono::high_resolution_clock::now();
+        size_t stored = 0;
+        const bool ok = checkpoint::write(conf.path, staging, conf.compress, &stored);
+        const double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+        if (ok) {
+            std::cout << "Checkpoint at step " << staging.step << ": " << (staging.bytes() >> 10) << " KB -> "
+                      << (stored >> 10) << " KB in " << (1000.0 * seconds) << "ms" << std::endl;
+        }
+        {
+            std::lock_guard<std::mutex> lock(m);
+            if (ok) {
+                saved_step = staging.step;
+                ++written;
+                write_s += seconds;
+            }
+            busy = false;
+        }
+        cv.notify_all();
+    }
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Config.hpp"
+
+class FDTD;
+
+// One named solver array (Ez, Hx, Hy, CPML psi strips)
+struct CheckpointSection {
+    std::string name;
+    std::vector<float> data;
+};
+
+// Complete restartable solver state; sources are stateless, so the step count covers them
+struct FieldSnapshot {
+    int nx = 0, ny = 0;
+    long long step = 0;
+    uint64_t fingerprint = 0;  // Grid, coefficients and sources the state belongs to
+    std::vector<CheckpointSection> sections;
+
+    size_t bytes() const;
+};
+
+// Checkpoint file "EM2DCKPT" version 1, native little-endian:
+//   magic[8] | u32 version | u32 sections | i32 nx | i32 ny | i64 step | u64 fingerprint | u32 header crc
+//   per section: u16 name length | name | u8 encoding | u64 floats | u64 stored bytes | u32 crc | payload
+// The section crc covers the decoded float bytes, so it also validates decompression.
+namespace checkpoint {
+constexpr uint32_t version = 1;
+
+uint32_t crc32(const void *data, size_t bytes, uint32_t crc = 0);
+uint64_t fnv1a(const void *data, size_t bytes, uint64_t hash = 14695981039346656037ull);
+
+// Writes <path>.tmp and renames it over <path>, so a crash never leaves a torn checkpoint
+bool write(const std::string &path, const FieldSnapshot &snap, bool compress, size_t *stored_bytes = nullptr);
+std::optional<FieldSnapshot> read(const std::string &path);
+}
+
+// Periodic asynchronous checkpoints of a running solver
+// maybeSave() only copies the solver arrays into a staging snapshot; a background
+// thread encodes and writes it. If the previous write is still in flight the
+// snapshot is deferred to a later call instead of blocking the time loop.
+class Checkpointer {
+public:
+    explicit Checkpointer(const CheckpointConfig &conf);
+    ~Checkpointer();
+    Checkpointer(const Checkpointer&) = delete;
+    Checkpointer& operator=(const Checkpointer&) = delete;
+
+    bool enabled() const { return conf.interval > 0; }
+    void maybeSave(const FDTD &sim);
+    void restart();                // The scene was rebuilt: the schedule starts over from its step 0
+    void finish(const FDTD &sim);  // Waits for the writer and saves the final state if it is newer
+
+private:
+    CheckpointConfig conf;
+    long long next_step = -1;
+    long long saved_step = -1;
+    FieldSnapshot staging;
+    bool busy = false;
+    bool quit = false;
+    size_t written = 0, deferred = 0, snapshots = 0;
+    double write_s = 0.0, snapshot_s = 0.0;
+    std::mutex m;
+    std::condition_variable cv;
+    std::thread writer;
+
+    void writerLoop();
+};
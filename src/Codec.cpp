@@ -0,0 +1,63 @@
+#include "Codec.hpp"
+
+namespace codec {
+
+void shuffle(const void *src, size_t count, size_t elem_size, std::vector<uint8_t> &out) {
+    const uint8_t *bytes = static_cast<const uint8_t*>(src);
+    out.resize(count * elem_size);
+    for (size_t k = 0; k < count; ++k) {
+        for (size_t b = 0; b < elem_size; ++b) out[b * count + k] = bytes[k * elem_size + b];
+    }
+}
+
+void unshuffle(const uint8_t *in, size_t count, size_t elem_size, void *dst) {
+    uint8_t *bytes = static_cast<uint8_t*>(dst);
+    for (size_t k = 0; k < count; ++k) {
+        for (size_t b = 0; b < elem_size; ++b) bytes[k * elem_size + b] = in[b * count + k];
+    }
+}
+
+void rleEncode(const uint8_t *in, size_t n, std::vector<uint8_t> &out) {
+    out.clear();
+    out.reserve(n / 4);
+    size_t i = 0;
+    while (i < n) {
+        size_t run = 1;
+        while (i + run < n && run < 130 && in[i + run] == in[i]) ++run;
+        if (run >= 3) {
+            out.push_back(static_cast<uint8_t>(0x80 | (run - 3)));
+            out.push_back(in[i]);
+            i += run;
+            continue;
+        }
+        const size_t start = i;
+        while (i < n && i - start < 128) {
+            if (i + 2 < n && in[i] == in[i + 1] && in[i] == in[i + 2]) break;
+            ++i;
+        }
+        out.push_back(static_cast<uint8_t>(i - start - 1));
+        out.insert(out.end(), in + start, in + i);
+    }
+}
+
+bool rleDecode(const uint8_t *in, size_t n, std::vector<uint8_t> &out, size_t expected) {
+    out.clear();
+    out.reserve(expected);
+    size_t i = 0;
+    while (i < n) {
+        const uint8_t c = in[i++];
+        if (c < 0x80) {
+            const size_t len = static_cast<size_t>(c) + 1;
+            if (i + len > n || out.size() + len > expected) return false;
+            out.insert(out.end(), in + i, in + i + len);
+            i += len;
+        } else {
+            const size_t len = static_cast<size_t>(c & 0x7f) + 3;
+            if (i >= n || out.size() + len > expected) return false;
+            out.insert(out.end(), len, in[i++]);
+        }
+    }
+    return out.size() == expected;
+}
+
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Lossless byte codecs shared by checkpoints, field exports and the viewer stream
+namespace codec {
+
+// Groups byte b of every element together, so slowly varying high bytes form long runs
+void shuffle(const void *src, size_t count, size_t elem_size, std::vector<uint8_t> &out);
+void unshuffle(const uint8_t *in, size_t count, size_t elem_size, void *dst);
+
+// PackBits-style run-length coding: control < 0x80 is a literal of control+1 bytes,
+// otherwise a run of (control & 0x7f)+3 copies of the next byte
+void rleEncode(const uint8_t *in, size_t n, std::vector<uint8_t> &out);
+bool rleDecode(const uint8_t *in, size_t n, std::vector<uint8_t> &out, size_t expected);
+
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+// FEMM-style diverging colour map shared by the raylib renderer and the headless exporters
+namespace colormap {
+
+struct RGBA {
+    unsigned char r, g, b, a;
+};
+
+inline RGBA map(float v, float color_range) {
+    // Normalize to color range with optimized clamping
+    float normalized = v / color_range;
+    normalized = std::clamp(normalized, -1.0f, 1.0f);
+    
+    // Enhanced ultra-high resolution color mapping with smoother gradients
+    const float abs_norm = std::abs(normalized);
+    
+    // Ultra-fine zero field detection for high resolution detail
+    if (abs_norm < 0.005f) {
+        // Very near zero: sophisticated dark blue-green gradient
+        unsigned char intensity = static_cast<unsigned char>(32 + 32 * abs_norm / 0.005f);
+        return RGBA{0, intensity, static_cast<unsigned char>(intensity + 16), 255};
+    }
+    
+    if (normalized < -0.85f) {
+        // Ultra-strong negative field: Deep blue to violet
+        float t = (abs_norm - 0.85f) / 0.15f;
+        unsigned char red = static_cast<unsigned char>(32 + 96 * t);
+        unsigned char green = static_cast<unsigned char>(16 * t);
+        unsigned char blue = 255;
+        return RGBA{red, green, blue, 255};
+    } else if (normalized < -0.6f) {
+        // Very strong negative field: Blue to deep blue
+        float t = (abs_norm - 0.6f) / 0.25f;
+        unsigned char red = static_cast<unsigned char>(8 * t);
+        unsigned char green = static_cast<unsigned char>(8 * t);
+        unsigned char blue = static_cast<unsigned char>(180 + 75 * t);
+        return RGBA{red, green, blue, 255};
+    } else if (normalized < -0.3f) {
+        // Strong negative field: Cyan to blue transition
+        float t = (abs_norm - 0.3f) / 0.3f;
+        unsigned char red = 0;
+        unsigned char green = static_cast<unsigned char>(128 * (1.0f - t));
+        unsigned char blue = static_cast<unsigned char>(128 + 127 * t);
+        return RGBA{red, green, blue, 255};
+    } else if (normalized < -0.1f) {
+        // Medium negative field: Green-cyan to cyan transition
+        float t = (abs_norm - 0.1f) / 0.2f;
+        unsigned char red = 0;
+        unsigned char green = static_cast<unsigned char>(64 + 64 * t);
+        unsigned char blue = static_cast<unsigned char>(96 + 32 * t);
+        return RGBA{red, green, blue, 255};
+    } else if (normalized < 0.1f) {
+        // Near zero field: Enhanced neutral field visualization
+        float t = abs_norm / 0.1f;
+        unsigned char base_intensity = static_cast<unsigned char>(48 + 48 * t);
+        return RGBA{base_intensity, static_cast<unsigned char>(base_intensity + 16), base_intensity, 255};
+    } else if (normalized < 0.3f) {
+        // Medium positive field: Green to yellow transition
+        float t = (abs_norm - 0.1f) / 0.2f;
+        unsigned char red = static_cast<unsigned char>(64 + 96 * t);
+        unsigned char green = static_cast<unsigned char>(128 + 64 * t);
+        unsigned char blue = static_cast<unsigned char>(32 * (1.0f - t));
+        return RGBA{red, green, blue, 255};
+    } else if (normalized < 0.6f) {
+        // Strong positive field: Yellow to orange transition
+        float t = (abs_norm - 0.3f) / 0.3f;
+        unsigned char red = static_cast<unsigned char>(160 + 95 * t);
+        unsigned char green = static_cast<unsigned char>(192 * (1.0f - 0.4f * t));
+        unsigned char blue = 0;
+        return RGBA{red, green, blue, 255};
+    } else if (normalized < 0.85f) {
+        // Very strong positive field: Orange to red
+        float t = (abs_norm - 0.6f) / 0.25f;
+        unsigned char red = 255;
+        unsigned char green = static_cast<unsigned char>(128 * (1.0f - t));
+        unsigned char blue = static_cast<unsigned char>(32 * t);
+        return RGBA{red, green, blue, 255};
+    } else {
+        // Ultra-strong positive field: Red to bright red-white
+        float t = (abs_norm - 0.85f) / 0.15f;
+        unsigned char red = 255;
+        unsigned char green = static_cast<unsigned char>(64 * t);
+        unsigned char blue = static_cast<unsigned char>(64 * t);
+        return RGBA{red, green, blue, 255};
+    }
+}
+
+// Colour-maps a w x h field into packed RGBA bytes (4 per pixel)
+inline void mapField(const float *field, int w, int h, float color_range, unsigned char *rgba) {
+    const size_t n = static_cast<size_t>(w) * h;
+    for (size_t k = 0; k < n; ++k) {
+        const RGBA c = map(field[k], color_range);
+        rgba[4*k] = c.r;
+        rgba[4*k + 1] = c.g;
+        rgba[4*k + 2] = c.b;
+        rgba[4*k + 3] = c.a;
+    }
+}
+
+}
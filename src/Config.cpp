@@ -9,11 +9,76 @@ using json = nlohmann::json;
 #error "nlohmann/json.hpp not found. Please install nlohmann-json or provide the header."
 #endif
 
+static void from_json(const json &j, SymmetryConfig &s) {
+    if (j.contains("x")) j.at("x").get_to(s.x);
+    if (j.contains("y")) j.at("y").get_to(s.y);
+    if (j.contains("period_x")) j.at("period_x").get_to(s.period_x);
+    if (j.contains("period_y")) j.at("period_y").get_to(s.period_y);
+}
+
+static void from_json(const json &j, RefineBox &r) {
+    j.at("x0").get_to(r.x0);
+    j.at("y0").get_to(r.y0);
+    j.at("w").get_to(r.w);
+    j.at("h").get_to(r.h);
+    if (j.contains("cell")) j.at("cell").get_to(r.cell);
+}
+
+static void from_json(const json &j, MeshConfig &m) {
+    if (j.contains("max_cell")) j.at("max_cell").get_to(m.max_cell);
+    if (j.contains("grading")) j.at("grading").get_to(m.grading);
+    if (j.contains("refine")) {
+        for (auto &ri : j.at("refine")) {
+            RefineBox r;
+            from_json(ri, r);
+            m.refine.push_back(r);
+        }
+    }
+}
+
+static void from_json(const json &j, AdaptiveConfig &a) {
+    if (j.contains("enabled")) j.at("enabled").get_to(a.enabled);
+    if (j.contains("tolerance")) j.at("tolerance").get_to(a.tolerance);
+    if (j.contains("tile_samples")) j.at("tile_samples").get_to(a.tile_samples);
+    if (j.contains("max_level")) j.at("max_level").get_to(a.max_level);
+    if (j.contains("display_max")) j.at("display_max").get_to(a.display_max);
+}
+
+static void from_json(const json &j, OutOfCoreConfig &o) {
+    if (j.contains("enabled")) j.at("enabled").get_to(o.enabled);
+    if (j.contains("path")) j.at("path").get_to(o.path);
+    if (j.contains("tile")) j.at("tile").get_to(o.tile);
+    if (j.contains("resident_mb")) j.at("resident_mb").get_to(o.resident_mb);
+    if (j.contains("display_max")) j.at("display_max").get_to(o.display_max);
+}
+
+static void from_json(const json &j, DecompositionConfig &d) {
+    if (j.contains("ranks")) j.at("ranks").get_to(d.ranks);
+    if (j.contains("transport")) j.at("transport").get_to(d.transport);
+}
+
+static void from_json(const json &j, SolverConfig &s) {
+    if (j.contains("precision")) j.at("precision").get_to(s.precision);
+    if (j.contains("kernel")) j.at("kernel").get_to(s.kernel);
+    if (j.contains("threads")) j.at("threads").get_to(s.threads);
+    if (j.contains("numa_nodes")) j.at("numa_nodes").get_to(s.numa_nodes);
+    if (j.contains("huge_pages")) j.at("huge_pages").get_to(s.huge_pages);
+}
+
 static void from_json(const json &j, GridConfig &g) {
     if (j.contains("nx")) j.at("nx").get_to(g.nx);
     if (j.contains("ny")) j.at("ny").get_to(g.ny);
     if (j.contains("dx")) j.at("dx").get_to(g.dx);
     if (j.contains("dy")) j.at("dy").get_to(g.dy);
+    if (j.contains("pml_cells")) j.at("pml_cells").get_to(g.pml_cells);
+    if (j.contains("pml_order")) j.at("pml_order").get_to(g.pml_order);
+    if (j.contains("pml_alpha_max")) j.at("pml_alpha_max").get_to(g.pml_alpha_max);
+    if (j.contains("symmetry")) from_json(j.at("symmetry"), g.symmetry);
+    if (j.contains("mesh")) from_json(j.at("mesh"), g.mesh);
+    if (j.contains("adaptive")) from_json(j.at("adaptive"), g.adaptive);
+    if (j.contains("out_of_core")) from_json(j.at("out_of_core"), g.out_of_core);
+    if (j.contains("decomposition")) from_json(j.at("decomposition"), g.decomposition);
+    if (j.contains("solver")) from_json(j.at("solver"), g.solver);
 }
 
 static void from_json(const json &j, MaterialBlock &m) {
@@ -43,29 +108,79 @@ static void from_json(const json &j, MagnetConfig &m) {
     if (j.contains("name")) j.at("name").get_to(m.name);
 }
 
+static void from_json(const json &j, FluxLineConfig &f) {
+    if (j.contains("show")) j.at("show").get_to(f.show);
+    if (j.contains("seeds")) j.at("seeds").get_to(f.seeds);
+    if (j.contains("max_points")) j.at("max_points").get_to(f.max_points);
+    if (j.contains("tolerance")) j.at("tolerance").get_to(f.tolerance);
+    if (j.contains("max_step")) j.at("max_step").get_to(f.max_step);
+}
+
 static void from_json(const json &j, VisualConfig &v) {
     if (j.contains("field")) j.at("field").get_to(v.field);
     if (j.contains("color_range")) j.at("color_range").get_to(v.color_range);
+    if (j.contains("flux_lines")) from_json(j.at("flux_lines"), v.flux_lines);
 }
 
-std::optional<Config> Config::loadFromFile(const std::string &path) {
-    std::ifstream ifs(path);
-    if (!ifs) {
-        std::cerr << "Could not open config file: " << path << "\n";
-        return std::nullopt;
-    }
-    json j;
-    try {
-        ifs >> j;
-    } catch (std::exception &e) {
-        std::cerr << "Failed to parse config: " << e.what() << "\n";
-        return std::nullopt;
+static void from_json(const json &j, CheckpointConfig &c) {
+    if (j.contains("interval")) j.at("interval").get_to(c.interval);
+    if (j.contains("path")) j.at("path").get_to(c.path);
+    if (j.contains("compress")) j.at("compress").get_to(c.compress);
+}
+
+static void from_json(const json &j, ExportConfig &e) {
+    if (j.contains("dir")) j.at("dir").get_to(e.dir);
+    if (j.contains("frame_interval")) j.at("frame_interval").get_to(e.frame_interval);
+    if (j.contains("frame_format")) j.at("frame_format").get_to(e.frame_format);
+    if (j.contains("field_interval")) j.at("field_interval").get_to(e.field_interval);
+    if (j.contains("field_chunk_rows")) j.at("field_chunk_rows").get_to(e.field_chunk_rows);
+    if (j.contains("compress")) j.at("compress").get_to(e.compress);
+    if (j.contains("queue_depth")) j.at("queue_depth").get_to(e.queue_depth);
+    if (j.contains("workers")) j.at("workers").get_to(e.workers);
+    if (j.contains("drop_when_full")) j.at("drop_when_full").get_to(e.drop_when_full);
+}
+
+static void from_json(const json &j, StreamConfig &s) {
+    if (j.contains("enabled")) j.at("enabled").get_to(s.enabled);
+    if (j.contains("endpoint")) j.at("endpoint").get_to(s.endpoint);
+    if (j.contains("tile")) j.at("tile").get_to(s.tile);
+    if (j.contains("range")) j.at("range").get_to(s.range);
+    if (j.contains("interval")) j.at("interval").get_to(s.interval);
+}
+
+static void from_json(const json &j, ProbeConfig &p) {
+    if (j.contains("name")) j.at("name").get_to(p.name);
+    if (j.contains("type")) j.at("type").get_to(p.type);
+    if (j.contains("quantity")) j.at("quantity").get_to(p.quantity);
+    if (j.contains("x")) j.at("x").get_to(p.x);
+    if (j.contains("y")) j.at("y").get_to(p.y);
+    if (j.contains("x1")) j.at("x1").get_to(p.x1);
+    if (j.contains("y1")) j.at("y1").get_to(p.y1);
+    if (j.contains("w")) j.at("w").get_to(p.w);
+    if (j.contains("h")) j.at("h").get_to(p.h);
+}
+
+static void from_json(const json &j, ProbeSetConfig &p) {
+    if (j.contains("dir")) j.at("dir").get_to(p.dir);
+    if (j.contains("interval")) j.at("interval").get_to(p.interval);
+    if (j.contains("buffer")) j.at("buffer").get_to(p.buffer);
+    if (j.contains("batch")) j.at("batch").get_to(p.batch);
+    if (j.contains("list")) {
+        for (auto &pi : j.at("list")) {
+            ProbeConfig probe;
+            from_json(pi, probe);
+            p.list.push_back(probe);
+        }
     }
+}
 
+static Config configFromJson(const json &j) {
     Config cfg;
     if (j.contains("grid")) from_json(j.at("grid"), cfg.grid);
     if (j.contains("timestepping") && j.at("timestepping").contains("max_steps"))
         cfg.max_steps = j.at("timestepping").at("max_steps").get<int>();
+    if (j.contains("timestepping") && j.at("timestepping").contains("steps_per_frame"))
+        cfg.steps_per_frame = j.at("timestepping").at("steps_per_frame").get<int>();
     if (j.contains("materials")) {
         for (auto &mi : j.at("materials")) {
             MaterialBlock m;
@@ -87,8 +202,80 @@ std::optional<Config> Config::loadFromFile(const std::string &path) {
             cfg.magnets.push_back(m);
         }
     }
+    if (j.contains("checkpoint")) from_json(j.at("checkpoint"), cfg.checkpoint);
+    if (j.contains("export")) from_json(j.at("export"), cfg.output);
+    if (j.contains("stream")) from_json(j.at("stream"), cfg.stream);
+    if (j.contains("probes")) from_json(j.at("probes"), cfg.probes);
     if (j.contains("visualization")) from_json(j.at("visualization"), cfg.vis);
     if (j.contains("scenario")) j.at("scenario").get_to(cfg.scenario);
 
     return cfg;
 }
+
+std::optional<Config> Config::loadFromFile(const std::string &path) {
+    std::ifstream ifs(path);
+    if (!ifs) {
+        std::cerr << "Could not open config file: " << path << "\n";
+        return std::nullopt;
+    }
+    // Schema errors (wrong types, missing keys) are reported like syntax errors, so a bad
+    // edit picked up by the viewer's hot reload keeps the active configuration
+    try {
+        json j;
+        ifs >> j;
+        return configFromJson(j);
+    } catch (std::exception &e) {
+        std::cerr << "Failed to parse config: " << e.what() << "\n";
+        return std::nullopt;
+    }
+}
+
+std::optional<Config> Config::loadFromString(const std::string &text) {
+    try {
+        return configFromJson(json::parse(text));
+    } catch (std::exception &e) {
+        std::cerr << "Failed to parse config: " << e.what() << "\n";
+        return std::nullopt;
+    }
+}
+
+static void from_json(const json &j, SweepParameter &p) {
+    j.at("target").get_to(p.target);
+    if (j.contains("values")) {
+        j.at("values").get_to(p.values);
+    } else {
+        const double from = j.at("from").get<double>();
+        const double to = j.contains("to") ? j.at("to").get<double>() : from;
+        const int steps = j.contains("steps") ? j.at("steps").get<int>() : 1;
+        for (int k = 0; k < steps; ++k) {
+            p.values.push_back(steps > 1 ? from + (to - from) * k / (steps - 1) : from);
+        }
+    }
+}
+
+std::optional<SweepConfig> SweepConfig::loadFromFile(const std::string &path) {
+    std::ifstream ifs(path);
+    if (!ifs) {
+        std::cerr << "Could not open sweep file: " << path << "\n";
+        return std::nullopt;
+    }
+    SweepConfig sweep;
+    try {
+        json j;
+        ifs >> j;
+        if (j.contains("base")) j.at("base").get_to(sweep.base);
+        if (j.contains("threads")) j.at("threads").get_to(sweep.threads);
+        if (j.contains("output")) j.at("output").get_to(sweep.output);
+        if (j.contains("parameters")) {
+            for (auto &pi : j.at("parameters")) {
+                SweepParameter p;
+                from_json(pi, p);
+                sweep.parameters.push_back(p);
+            }
+        }
+    } catch (std::exception &e) {
+        std::cerr << "Failed to parse sweep: " << e.what() << "\n";
+        return std::nullopt;
+    }
+    return sweep;
+}
@@ -4,16 +4,98 @@
 #include <vector>
 #include <optional>
 
+// Symmetry planes / periodicity used to shrink the computed domain.
+// Mirror planes sit on the centre node of the axis, which needs an odd cell count: "pec"
+// (Ez odd, Ez = 0 on the plane) or "pmc" (Ez even). "periodic" repeats a unit cell of
+// period_x/period_y cells.
+struct SymmetryConfig {
+    std::string x = "none";  // none | pec | pmc | periodic
+    std::string y = "none";
+    int period_x = 0;
+    int period_y = 0;
+    bool operator==(const SymmetryConfig&) const = default;
+};
+
+// Local refinement box in display-grid cells; cell is the target spacing inside it
+struct RefineBox {
+    int x0 = 0, y0 = 0, w = 0, h = 0;
+    double cell = 0.5;
+    bool operator==(const RefineBox&) const = default;
+};
+
+// Graded non-uniform mesh. Spacings are in display cells (1.0 = dx/dy of the display grid);
+// away from refinement boxes the spacing grows by at most `grading` per cell up to max_cell
+struct MeshConfig {
+    double max_cell = 1.0;
+    double grading = 1.2;
+    std::vector<RefineBox> refine;
+    bool operator==(const MeshConfig&) const = default;
+};
+
+// Adaptive quadtree representation of the static magnet field. Tiles split until
+// bilinear interpolation of their sample lattice matches the dipole field within
+// `tolerance`, so smooth far-field regions stay a handful of large tiles.
+struct AdaptiveConfig {
+    bool enabled = false;
+    double tolerance = 0.01;  // Max interpolation error per tile (field is clamped to +-5)
+    int tile_samples = 8;     // Sample intervals along each tile edge
+    int max_level = 16;       // Deepest subdivision below the root tile
+    int display_max = 1024;   // Longest edge of the rasterized display grid
+    bool operator==(const AdaptiveConfig&) const = default;
+};
+
+// Out-of-core fields: each field lives in a memory-mapped file of square tiles
+// (<path>.ez, and <path>.hx / <path>.hy once a time-domain source is added)
+struct OutOfCoreConfig {
+    bool enabled = false;
+    std::string path = "em2d_field";
+    int tile = 256;            // Tile edge in cells
+    int resident_mb = 2048;    // Larger mappings drop finished tile rows from memory while streaming
+    int display_max = 1024;    // Longest edge of the downsampled preview
+    bool operator==(const OutOfCoreConfig&) const = default;
+};
+
+// Multi-process strip decomposition of time-domain runs (POSIX hosts)
+struct DecompositionConfig {
+    int ranks = 1;                  // Worker processes; 1 keeps the single-process solver
+    std::string transport = "shm";  // Halo exchange transport
+    bool operator==(const DecompositionConfig&) const = default;
+};
+
+// Scalar type and kernel schedule of the in-memory time-domain update and the static dipole evaluation.
+// "half" stores the Yee fields as fp16 and does the arithmetic in fp32; "double" computes the static
+// field in double too. Kernels: "threaded" (rows across threads, vectorized), "simd" (one thread,
+// vectorized) or "scalar" (one thread, element at a time - the reference for benchmarks).
+struct SolverConfig {
+    std::string precision = "float";  // float | double | half
+    std::string kernel = "threaded";  // threaded | simd | scalar | pinned
+    int threads = 0;                  // Pinned kernel: worker threads (0 = all allowed CPUs)
+    int numa_nodes = 0;               // Pinned kernel: NUMA nodes to spread over (0 = all)
+    bool huge_pages = true;           // Pinned kernel: request transparent huge pages for the fields
+    bool operator==(const SolverConfig&) const = default;
+};
+
 struct GridConfig {
     int nx = 256;
     int ny = 256;
     double dx = 0.002;
     double dy = 0.002;
+    int pml_cells = 0;            // CPML absorbing layer thickness (0 = reflecting PEC walls)
+    double pml_order = 3.0;       // Polynomial grading order of the PML conductivity
+    double pml_alpha_max = 0.05;  // Complex frequency shift at the PML interface (S/m)
+    SymmetryConfig symmetry;
+    MeshConfig mesh;
+    AdaptiveConfig adaptive;
+    OutOfCoreConfig out_of_core;
+    DecompositionConfig decomposition;
+    SolverConfig solver;
+    bool operator==(const GridConfig&) const = default;
 };
 
 struct MaterialBlock {
     int x0 = 0, y0 = 0, w = 10, h = 10;
     double eps_r = 1.0;
+    bool operator==(const MaterialBlock&) const = default;
 };
 
 struct SourceConfig {
@@ -24,6 +106,7 @@ struct SourceConfig {
     double t0 = 50.0;
     double spread = 20.0;
     double freq_hz = 1e8;
+    bool operator==(const SourceConfig&) const = default;
 };
 
 struct MagnetConfig {
@@ -33,21 +116,115 @@ struct MagnetConfig {
     double moment_y = 1.0;  // Magnetic moment Y component
     double strength = 1.0;  // Magnet strength
     std::string name = "magnet"; // Optional name for identification
+    bool operator==(const MagnetConfig&) const = default;
+};
+
+// Periodic checkpoints of time-domain runs, written by a background thread
+struct CheckpointConfig {
+    int interval = 0;                 // Steps between checkpoints; 0 disables them
+    std::string path = "em2d.ckpt";   // Replaced atomically on every write
+    bool compress = true;             // Byte-shuffle + run-length encoding (lossless)
+    bool operator==(const CheckpointConfig&) const = default;
+};
+
+// Headless export of colour-mapped frames and raw field snapshots, drained by worker threads
+struct ExportConfig {
+    std::string dir = "export";
+    int frame_interval = 0;            // Steps between frames; 0 disables frame export
+    std::string frame_format = "png";  // "png" or "rgba" (raw 8-bit RGBA)
+    int field_interval = 0;            // Steps between float field snapshots; 0 disables them
+    int field_chunk_rows = 256;        // Rows per independently checksummed chunk
+    bool compress = true;              // Deflate PNGs and run-length encode field chunks
+    int queue_depth = 8;               // Buffers waiting for the writers
+    int workers = 2;
+    bool drop_when_full = false;       // Drop exports instead of waiting when the queue is full
+    bool operator==(const ExportConfig&) const = default;
+};
+
+// Live field stream for remote viewers (em2d --view <endpoint>)
+struct StreamConfig {
+    bool enabled = false;
+    std::string endpoint = "tcp:127.0.0.1:7070";  // or "unix:/tmp/em2d.sock"
+    int tile = 64;           // Changed-tile granularity in cells
+    double range = 0.0;      // 16-bit quantization full scale; 0 = twice the colour range
+    int interval = 1;        // Publish every n-th frame
+    bool operator==(const StreamConfig&) const = default;
+};
+
+// One field probe, in display cells of the irreducible region. "point" records the field at (x, y),
+// "line" every mesh node from (x, y) to (x1, y1); "rect" integrates over [x, x+w] x [y, y+h]:
+// "energy" is the field energy per unit depth, "flux" the outward Poynting flux through its edges.
+struct ProbeConfig {
+    std::string name = "probe";      // Output file <dir>/<name>.csv
+    std::string type = "point";      // point | line | rect
+    std::string quantity = "ez";     // point/line: ez | hx | hy; rect: energy | flux
+    int x = 0, y = 0;
+    int x1 = 0, y1 = 0;              // Line end point
+    int w = 1, h = 1;                // Rectangle extent
+    bool operator==(const ProbeConfig&) const = default;
+};
+
+// Probes of in-memory time-domain runs, sampled inside the time loop into per-probe ring buffers
+// that a writer thread flushes in batches
+struct ProbeSetConfig {
+    std::string dir = "probes";
+    int interval = 1;                // Steps between samples
+    int buffer = 8192;               // Ring-buffer slots per probe
+    int batch = 1024;                // Samples per flush
+    std::vector<ProbeConfig> list;
+    bool operator==(const ProbeSetConfig&) const = default;
+};
+
+// FEMM-style flux lines over static magnet fields, traced from a regular seed grid in both directions
+struct FluxLineConfig {
+    bool show = false;         // Overlay from start-up; F toggles it in the viewer
+    int seeds = 1024;          // Approximate number of lines
+    int max_points = 512;      // Polyline vertices per line
+    double tolerance = 0.05;   // RK local error per step in display cells
+    double max_step = 4.0;     // Largest integration step in display cells
+    bool operator==(const FluxLineConfig&) const = default;
 };
 
 struct VisualConfig {
     std::string field = "Ez";
     double color_range = 1.0;
+    FluxLineConfig flux_lines;
+    bool operator==(const VisualConfig&) const = default;
 };
 
 struct Config {
     GridConfig grid;
     int max_steps = 10000;
+    int steps_per_frame = 1; // Time-domain steps advanced per rendered frame
     std::vector<MaterialBlock> materials;
     std::vector<SourceConfig> sources;
     std::vector<MagnetConfig> magnets; // New: magnet configurations
+    CheckpointConfig checkpoint;
+    ExportConfig output;
+    StreamConfig stream;
+    ProbeSetConfig probes;
     VisualConfig vis;
     std::string scenario = "default"; // New: scenario name
 
     static std::optional<Config> loadFromFile(const std::string &path);
+    static std::optional<Config> loadFromString(const std::string &text);  // Same schema as the config file
+
+    bool operator==(const Config&) const = default;
+};
+
+// One swept parameter, e.g. "magnets[2].strength" or "materials[0].eps_r".
+// JSON gives either "values": [...] or a "from"/"to"/"steps" range.
+struct SweepParameter {
+    std::string target;
+    std::vector<double> values;
+};
+
+// Parameter sweep (em2d --sweep sweep.json): every combination of parameter values is one variant
+struct SweepConfig {
+    std::string base = "em2d_sfml/assets/config.json";
+    std::vector<SweepParameter> parameters;
+    int threads = 0;          // Worker threads; 0 = hardware concurrency
+    std::string output;       // Optional CSV with one row per variant
+
+    static std::optional<SweepConfig> loadFromFile(const std::string &path);
 };
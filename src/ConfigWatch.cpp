@@ -0,0 +1,80 @@
+#include "ConfigWatch.hpp"
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <utility>
+
+bool ConfigDiff::empty() const {
+    return !grid && !materials && !sources && magnets.empty() && !color_range && !flux_lines && !run && startup.empty();
+}
+
+std::string ConfigDiff::summary() const {
+    std::ostringstream out;
+    const char *sep = "";
+    auto item = [&](bool on, const char *name) {
+        if (!on) return;
+        out << sep << name;
+        sep = "; ";
+    };
+    item(grid, "grid");
+    item(materials, "materials");
+    item(sources, "sources");
+    if (!magnets.empty()) {
+        out << sep << (magnets.size() == 1 ? "magnet " : "magnets ");
+        for (size_t k = 0; k < magnets.size(); ++k) out << (k ? "," : "") << magnets[k];
+        sep = "; ";
+    }
+    item(color_range, "colour range");
+    item(flux_lines, "flux lines");
+    item(run, "run length");
+    for (const auto &s : startup) item(true, s.c_str());
+    return out.str();
+}
+
+ConfigDiff diffConfig(const Config &active, const Config &next) {
+    ConfigDiff d;
+    d.grid = !(active.grid == next.grid);
+    d.materials = active.materials != next.materials;
+    d.sources = active.sources != next.sources;
+    const size_t magnets = std::max(active.magnets.size(), next.magnets.size());
+    for (size_t k = 0; k < magnets; ++k) {
+        if (k >= active.magnets.size() || k >= next.magnets.size() || !(active.magnets[k] == next.magnets[k])) {
+            d.magnets.push_back(k);
+        }
+    }
+    d.color_range = active.vis.color_range != next.vis.color_range;
+    d.flux_lines = !(active.vis.flux_lines == next.vis.flux_lines);
+    d.run = active.max_steps != next.max_steps || active.steps_per_frame != next.steps_per_frame;
+    if (!(active.checkpoint == next.checkpoint)) d.startup.push_back("checkpoint");
+    if (!(active.output == next.output)) d.startup.push_back("export");
+    if (!(active.stream == next.stream)) d.startup.push_back("stream");
+    if (!(active.probes == next.probes)) d.startup.push_back("probes");
+    return d;
+}
+
+ConfigWatcher::ConfigWatcher(std::string path, int interval_ms)
+: file(std::move(path)), interval(std::max(interval_ms, 1)), next_check(std::chrono::steady_clock::now()),
+  modified_at(next_check) {
+    // The file as loaded at start-up is the baseline
+    std::error_code ec;
+    const auto t = std::filesystem::last_write_time(file, ec);
+    if (!ec) seen = t;
+}
+
+std::optional<Config> ConfigWatcher::poll() {
+    const auto now = std::chrono::steady_clock::now();
+    if (now < next_check) return std::nullopt;
+    next_check = now + interval;
+
+    std::error_code ec;
+    const auto t = std::filesystem::last_write_time(file, ec);
+    if (ec || (seen && *seen == t)) return std::nullopt;  // Missing (mid-save) or unchanged
+    seen = t;
+    // file_clock has no portable conversion in C++20 library implementations yet; its age does
+    const auto age = std::filesystem::file_time_type::clock::now() - t;
+    modified_at = now - std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::max(age, decltype(age)::zero()));
+
+    auto cfg = Config::loadFromFile(file);
+    if (!cfg) std::cout << "Config " << file << " changed but did not load - keeping the active configuration" << std::endl;
+    return cfg;
+}
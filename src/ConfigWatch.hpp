@@ -0,0 +1,47 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+#include "Config.hpp"
+
+// Differences between the active and a reloaded configuration, grouped by how much of the
+// running scene they invalidate
+struct ConfigDiff {
+    bool grid = false;                 // Solver, field and renderer are rebuilt
+    bool materials = false;            // Time-domain scenes restart; static fields ignore materials
+    bool sources = false;              // Scene restart
+    std::vector<size_t> magnets;       // Changed, added or removed indices: local static-field update
+    bool color_range = false;          // Colour lookup table rebuild
+    bool flux_lines = false;           // Overlay settings: lines are retraced
+    bool run = false;                  // max_steps / steps_per_frame, applied as they are
+    std::vector<std::string> startup;  // Sections only read at start-up (checkpoint, export, ...)
+
+    bool empty() const;
+    std::string summary() const;       // e.g. "magnets 0,2; colour range"
+};
+
+ConfigDiff diffConfig(const Config &active, const Config &next);
+
+// Watches a config file for the viewer's hot reload. poll() checks the modification time
+// (at most every interval_ms) and re-parses the file when it changed; a file that does not
+// parse is reported once per modification and the active configuration stays in place.
+class ConfigWatcher {
+public:
+    explicit ConfigWatcher(std::string path, int interval_ms = 250);
+
+    std::optional<Config> poll();
+    // Steady-clock estimate of when the file was written, for edit-to-display latency
+    std::chrono::steady_clock::time_point modifiedAt() const { return modified_at; }
+    const std::string& path() const { return file; }
+
+private:
+    std::string file;
+    std::chrono::milliseconds interval;
+    std::chrono::steady_clock::time_point next_check;
+    std::optional<std::filesystem::file_time_type> seen;  // Modification time last parsed
+    std::chrono::steady_clock::time_point modified_at;
+};
@@ -0,0 +1,326 @@
+#include "Decomposition.hpp"
+#include "FDTD.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <thread>
+
+#ifndef _WIN32
+#include <csignal>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+struct DomainDecomposition::Control {
+    std::atomic<int> epoch;   // Bumped by the parent for every advance() request
+    std::atomic<int> steps;
+    std::atomic<int> done;    // Ranks that finished the current request
+    std::atomic<int> quit;
+};
+
+struct DomainDecomposition::RankStats {
+    int j0, j1;
+    long long steps;
+    double compute_s;
+    double halo_wait_s;
+};
+
+namespace {
+// Spin briefly, then back off so idle workers do not steal the renderer's CPU
+template <typename Pred>
+void waitUntil(Pred ready) {
+    for (int spins = 0; !ready(); ++spins) {
+        if (spins < 1000) std::this_thread::yield();
+        else std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+}
+}
+
+DomainDecomposition::DomainDecomposition(const GridConfig &grid_, double c0dt_)
+: grid(grid_), c0dt(c0dt_) {
+    // At least two rows per strip so interior and halo rows never coincide
+    ranks = std::clamp(grid.decomposition.ranks, 1, std::max(1, grid.ny / 2));
+    if (grid.decomposition.transport != "shm") {
+        std::cout << "Unknown halo transport '" << grid.decomposition.transport << "' - using shm" << std::endl;
+    }
+    std::cout << "Domain decomposition: " << ranks << " worker processes, " << (grid.ny / ranks)
+              << "+ rows per strip, shared-memory halo rings" << std::endl;
+}
+
+DomainDecomposition::~DomainDecomposition() {
+    stop();
+#ifndef _WIN32
+    if (shared) munmap(shared, shared_bytes);
+#endif
+}
+
+bool DomainDecomposition::supported() {
+#ifdef _WIN32
+    return false;
+#else
+    return true;
+#endif
+}
+
+DomainDecomposition::Control* DomainDecomposition::control() const {
+    return reinterpret_cast<Control*>(shared);
+}
+
+DomainDecomposition::RankStats* DomainDecomposition::stats() const {
+    return reinterpret_cast<RankStats*>(shared + 64);
+}
+
+float* DomainDecomposition::field() const {
+    const size_t offset = (64 + ranks * sizeof(RankStats) + 63) & ~static_cast<size_t>(63);
+    return reinterpret_cast<float*>(shared + offset);
+}
+
+bool DomainDecomposition::start() {
+#ifdef _WIN32
+    std::cout << "Domain decomposition needs fork() - running nothing" << std::endl;
+    failed = true;
+    return false;
+#else
+    auto shm = std::make_unique<ShmRingTransport>(ranks, static_cast<size_t>(grid.nx));
+    if (!shm->valid()) {
+        failed = true;
+        return false;
+    }
+    transport = std::move(shm);
+
+    const size_t field_offset = (64 + ranks * sizeof(RankStats) + 63) & ~static_cast<size_t>(63);
+    shared_bytes = field_offset + static_cast<size_t>(grid.nx) * grid.ny * sizeof(float);
+    void *p = mmap(nullptr, shared_bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) {
+        std::cerr << "Could not map " << (shared_bytes >> 20) << " MB shared field for decomposition\n";
+        failed = true;
+        return false;
+    }
+    shared = static_cast<char*>(p);
+    Control *ctrl = new (shared) Control;
+    ctrl->epoch.store(0);
+    ctrl->steps.store(0);
+    ctrl->done.store(0);
+    ctrl->quit.store(0);
+
+    std::cout.flush();
+    std::cerr.flush();
+    for (int r = 0; r < ranks; ++r) {
+        const pid_t pid = fork();
+        if (pid == 0) runWorker(r);
+        if (pid < 0) {
+            std::cerr << "fork() failed for rank " << r << "\n";
+            failed = true;
+            stop();
+            return false;
+        }
+        pids.push_back(static_cast<int>(pid));
+    }
+    std::cout << "Started " << ranks << " solver processes" << std::endl;
+    return true;
+#endif
+}
+
+bool DomainDecomposition::advance(int steps) {
+    if (failed) return false;
+    if (steps <= 0) return true;
+    if (pids.empty() && !start()) return false;
+
+    Control *ctrl = control();
+    ctrl->done.store(0, std::memory_order_relaxed);
+    ctrl->steps.store(steps, std::memory_order_relaxed);
+    ctrl->epoch.fetch_add(1, std::memory_order_release);
+
+    int polls = 0;
+    waitUntil([&] {
+        if (ctrl->done.load(std::memory_order_acquire) == ranks) return true;
+        if (++polls % 4096 == 0 && !workersAlive()) return true;
+        return false;
+    });
+    return !failed;
+}
+
+bool DomainDecomposition::workersAlive() {
+#ifndef _WIN32
+    for (int pid : pids) {
+        int status = 0;
+        if (waitpid(pid, &status, WNOHANG) == pid) {
+            std::cerr << "Solver process " << pid << " exited unexpectedly - stopping decomposed run\n";
+            failed = true;
+            stop();
+            return false;
+        }
+    }
+#endif
+    return true;
+}
+
+void DomainDecomposition::gather(std::vector<float> &out) const {
+    const size_t n = static_cast<size_t>(grid.nx) * grid.ny;
+    if (!shared) {
+        out.assign(n, 0.0f);
+        return;
+    }
+    const float *src = field();
+    out.assign(src, src + n);
+}
+
+void DomainDecomposition::reset() {
+    stop();
+#ifndef _WIN32
+    if (shared) munmap(shared, shared_bytes);
+#endif
+    shared = nullptr;
+    shared_bytes = 0;
+    transport.reset();
+}
+
+void DomainDecomposition::stop() {
+#ifndef _WIN32
+    if (pids.empty()) return;
+    control()->quit.store(1, std::memory_order_release);
+    for (int pid : pids) {
+        if (failed) kill(pid, SIGTERM);
+        waitpid(pid, nullptr, 0);
+    }
+    pids.clear();
+
+    std::cout << "?? Per-rank timing:" << std::endl;
+    std::cout << "   rank  rows          steps   compute ms   halo wait ms   wait %" << std::endl;
+    for (int r = 0; r < ranks; ++r) {
+        const RankStats &s = stats()[r];
+        const double total = s.compute_s + s.halo_wait_s;
+        std::cout << "   " << std::setw(4) << r << "  [" << std::setw(5) << s.j0 << "," << std::setw(5) << s.j1 << ")"
+                  << std::setw(8) << s.steps << std::fixed << std::setprecision(1)
+                  << std::setw(13) << s.compute_s * 1000.0 << std::setw(15) << s.halo_wait_s * 1000.0
+                  << std::setw(9) << (total > 0.0 ? 100.0 * s.halo_wait_s / total : 0.0)
+                  << std::defaultfloat << std::endl;
+    }
+#endif
+}
+
+void DomainDecomposition::runWorker(int rank) {
+    // The parent may have installed stop-request handlers; a worker must die on the SIGTERM stop() sends
+    std::signal(SIGTERM, SIG_DFL);
+    std::signal(SIGINT, SIG_DFL);
+    transport->attach(rank);
+    Control *ctrl = control();
+    RankStats &st = stats()[rank];
+    const int nx = grid.nx, ny = grid.ny;
+    const int j0 = static_cast<int>(static_cast<long long>(rank) * ny / ranks);
+    const int j1 = static_cast<int>(static_cast<long long>(rank + 1) * ny / ranks);
+    const int h = j1 - j0;
+    const int up = rank > 0 ? rank - 1 : -1;
+    const int down = rank + 1 < ranks ? rank + 1 : -1;
+    st = {j0, j1, 0, 0.0, 0.0};
+
+    // Local row r holds global row j0 - 1 + r: row 0 and row h+1 are ghosts
+    const size_t n = static_cast<size_t>(h + 2) * nx;
+    std::vector<float> Ez(n, 0.0f), Hx(n, 0.0f), Hy(n, 0.0f);
+    std::vector<float> cez(n, static_cast<float>(c0dt));
+    for (int r = 0; r < h + 2; ++r) {
+        const int j = j0 - 1 + r;
+        for (const auto &m : materials) {
+            if (j < m.y0 || j >= m.y0 + m.h) continue;
+            for (int i = std::max(m.x0, 0); i < std::min(m.x0 + m.w, nx); ++i) {
+                cez[static_cast<size_t>(r) * nx + i] = static_cast<float>(c0dt / m.eps_r);
+            }
+        }
+    }
+    std::vector<std::pair<size_t, Source>> owned_sources;
+    for (const auto &s : sources) {
+        if (s.x >= 0 && s.x < nx && s.y >= j0 && s.y < j1) {
+            owned_sources.emplace_back(static_cast<size_t>(s.y - j0 + 1) * nx + s.x, Source(s));
+        }
+    }
+
+    const float chy = static_cast<float>(c0dt) * static_cast<float>(1.0 / grid.dx);
+    const float chx = static_cast<float>(c0dt) * static_cast<float>(1.0 / grid.dy);
+    const float inv_dx = static_cast<float>(1.0 / grid.dx);
+    const float inv_dy = static_cast<float>(1.0 / grid.dy);
+
+    // Same kernels as FDTD::updateH / updateE on local rows [r0, r1)
+    auto updateH = [&](int r0, int r1) {
+        for (int r = r0; r < r1; ++r) {
+            const size_t row = static_cast<size_t>(r) * nx;
+            const float *ez0 = &Ez[row];
+            float *hy = &Hy[row];
+            for (int i = 0; i < nx - 1; ++i) hy[i] += chy * (ez0[i+1] - ez0[i]);
+            if (j0 - 1 + r < ny - 1) {
+                const float *ez1 = ez0 + nx;
+                float *hx = &Hx[row];
+                for (int i = 0; i < nx; ++i) hx[i] -= chx * (ez1[i] - ez0[i]);
+            }
+        }
+    };
+    auto updateE = [&](int r0, int r1) {
+        for (int r = r0; r < r1; ++r) {
+            const int j = j0 - 1 + r;
+            if (j < 1 || j >= ny - 1) continue;
+            const size_t row = static_cast<size_t>(r) * nx;
+            const float *hx1 = &Hx[row];
+            const float *hx0 = hx1 - nx;
+            const float *hy = &Hy[row];
+            const float *ce = &cez[row];
+            float *ez = &Ez[row];
+            for (int i = 1; i < nx - 1; ++i) {
+                ez[i] += ce[i] * ((hy[i] - hy[i-1]) * inv_dx - (hx1[i] - hx0[i]) * inv_dy);
+            }
+        }
+    };
+
+    using clock = std::chrono::high_resolution_clock;
+    double wait_s = 0.0;
+    auto timedRecv = [&](int peer, float *dst) {
+        auto t0 = clock::now();
+        transport->recv(peer, dst, nx);
+        wait_s += std::chrono::duration<double>(clock::now() - t0).count();
+    };
+
+    long long nstep = 0;
+    int seen = 0;
+    while (true) {
+        waitUntil([&] { return ctrl->epoch.load(std::memory_order_acquire) != seen ||
+                               ctrl->quit.load(std::memory_order_acquire) != 0; });
+        if (ctrl->quit.load(std::memory_order_acquire)) break;
+        seen = ctrl->epoch.load(std::memory_order_acquire);
+        const int steps = ctrl->steps.load(std::memory_order_relaxed);
+
+        auto start = clock::now();
+        wait_s = 0.0;
+        for (int s = 0; s < steps; ++s) {
+            // H: rows with local neighbours first, then the last row once the Ez ghost has arrived
+            updateH(1, h);
+            if (down >= 0 && nstep > 0) timedRecv(down, &Ez[static_cast<size_t>(h + 1) * nx]);
+            updateH(h, h + 1);
+            if (down >= 0) transport->send(down, &Hx[static_cast<size_t>(h) * nx], nx);
+
+            // E: interior rows overlap the Hx halo transfer, the first row waits for it
+            updateE(2, h + 1);
+            if (up >= 0) timedRecv(up, &Hx[0]);
+            updateE(1, 2);
+
+            for (auto &src : owned_sources) Ez[src.first] += src.second.value(static_cast<double>(nstep));
+            if (up >= 0) transport->send(up, &Ez[nx], nx);
+            ++nstep;
+        }
+        std::memcpy(field() + static_cast<size_t>(j0) * nx, &Ez[nx], static_cast<size_t>(h) * nx * sizeof(float));
+
+        const double total = std::chrono::duration<double>(clock::now() - start).count();
+        st.steps = nstep;
+        st.compute_s += total - wait_s;
+        st.halo_wait_s += wait_s;
+        ctrl->done.fetch_add(1, std::memory_order_acq_rel);
+    }
+#ifndef _WIN32
+    _exit(0);
+#else
+    std::exit(0);
+#endif
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include "Config.hpp"
+#include "HaloTransport.hpp"
+
+// Time-domain solve split into horizontal strips across forked worker processes
+// Each worker owns a block of rows plus one ghost row on either side and exchanges one
+// Hx row and one Ez row per step with its neighbours through a HaloTransport, updating
+// its interior rows while the halo is in flight. The parent only issues steps and reads
+// the owned rows back from a shared full-domain Ez buffer.
+// Uniform grid with PEC outer walls; CPML, symmetry and graded meshes are not decomposed.
+class DomainDecomposition {
+public:
+    DomainDecomposition(const GridConfig &grid, double c0dt);
+    ~DomainDecomposition();
+    DomainDecomposition(const DomainDecomposition&) = delete;
+    DomainDecomposition& operator=(const DomainDecomposition&) = delete;
+
+    static bool supported();
+    int rankCount() const { return ranks; }
+
+    // Scene setup, forwarded by FDTD before the first step
+    void addMaterialBlock(const MaterialBlock &block) { materials.push_back(block); }
+    void addSource(const SourceConfig &source) { sources.push_back(source); }
+
+    // Every rank advances `steps` time steps; workers are forked on the first call.
+    // False once the run has failed (workers could not start or one died): nothing advanced.
+    bool advance(int steps);
+    void gather(std::vector<float> &out) const;
+    void stop();  // Stops the workers and prints per-rank timing
+    void reset(); // Drops the workers and their field; the next advance() restarts from the stored scene
+
+private:
+    struct Control;
+    struct RankStats;
+
+    GridConfig grid;
+    double c0dt;
+    int ranks;
+    std::vector<MaterialBlock> materials;
+    std::vector<SourceConfig> sources;
+
+    std::unique_ptr<HaloTransport> transport;
+    char *shared = nullptr;        // Control block, per-rank stats and the gathered Ez field
+    size_t shared_bytes = 0;
+    std::vector<int> pids;
+    bool failed = false;
+
+    Control* control() const;
+    RankStats* stats() const;
+    float* field() const;
+    bool start();
+    bool workersAlive();
+    [[noreturn]] void runWorker(int rank);
+};
@@ -0,0 +1,196 @@
+#include "Export.hpp"
+#include "Checkpoint.hpp"
+#include "Colormap.hpp"
+#include "FDTD.hpp"
+#include "Png.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+ExportPipeline::ExportPipeline(const ExportConfig &conf_)
+: conf(conf_), created(std::chrono::steady_clock::now()) {
+    if (!enabled()) return;
+    if (conf.frame_format != "png" && conf.frame_format != "rgba") {
+        std::cout << "Unknown export frame format '" << conf.frame_format << "' - using png" << std::endl;
+        conf.frame_format = "png";
+    }
+    conf.queue_depth = std::max(conf.queue_depth, 1);
+    conf.workers = std::max(conf.workers, 1);
+    conf.field_chunk_rows = std::max(conf.field_chunk_rows, 1);
+
+    std::error_code ec;
+    std::filesystem::create_directories(conf.dir, ec);
+    if (ec) {
+        std::cerr << "Could not create export directory " << conf.dir << ": " << ec.message() << " - export disabled\n";
+        conf.frame_interval = conf.field_interval = 0;
+        return;
+    }
+    std::cout << "Exporting to " << conf.dir << "/: ";
+    if (conf.frame_interval > 0) std::cout << conf.frame_format << " frames every " << conf.frame_interval << " steps ";
+    if (conf.field_interval > 0) std::cout << "field snapshots every " << conf.field_interval << " steps ";
+    std::cout << "(" << conf.workers << " writers, queue " << conf.queue_depth
+              << (conf.drop_when_full ? ", drop when full)" : ", block when full)") << std::endl;
+
+    for (int k = 0; k < conf.workers; ++k) workers.emplace_back([this] { workerLoop(); });
+}
+
+ExportPipeline::~ExportPipeline() {
+    {
+        std::lock_guard<std::mutex> lock(m);
+        stopping = true;
+    }
+    not_empty.notify_all();
+    for (auto &t : workers) t.join();
+}
+
+bool ExportPipeline::due(long long step, int interval, long long &next) {
+    if (interval <= 0) return false;
+    if (next < 0) next = (step + interval - 1) / interval * interval;  // First multiple at or after the start step
+    if (step < next) return false;
+    next = (step / interval + 1) * interval;
+    return true;
+}
+
+void ExportPipeline::capture(const FDTD &sim, float color_range) {
+    if (!enabled()) return;
+    Job job;
+    job.step = sim.getStep();
+    if (sim.isTimeDomain()) {
+        job.frame = due(job.step, conf.frame_interval, next_frame);
+        job.field = due(job.step, conf.field_interval, next_field);
+    } else if (!static_done) {
+        // A static field never changes, one export of each kind is enough
+        job.frame = conf.frame_interval > 0;
+        job.field = conf.field_interval > 0;
+        static_done = true;
+    }
+    if (!job.frame && !job.field) return;
+
+    {
+        std::unique_lock<std::mutex> lock(m);
+        if (queue.size() >= static_cast<size_t>(conf.queue_depth)) {
+            if (conf.drop_when_full) {
+                ++dropped;
+                return;
+            }
+            auto start = std::chrono::steady_clock::now();
+            not_full.wait(lock, [this] { return queue.size() < static_cast<size_t>(conf.queue_depth); });
+            blocked_s += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+    }
+
+    // The only copy on the simulation thread; buffers cycle through the pool, so steady state allocates nothing.
+    // Frame-only jobs need it too: the solver overwrites its buffer once capture() returns, and colour
+    // mapping here instead (the only other way to hand the writers a stable image) costs ~10x the copy.
+    const std::vector<float> &field = sim.getEz();
+    job.w = sim.displayWidth();
+    job.h = sim.displayHeight();
+    job.color_range = color_range;
+    job.data = buffers.acquire();
+    if (!job.data) job.data = std::make_unique<std::vector<float>>();
+    job.data->assign(field.begin(), field.end());
+
+    {
+        std::lock_guard<std::mutex> lock(m);
+        queue.push_back(std::move(job));
+        peak_depth = std::max(peak_depth, queue.size());
+    }
+    not_empty.notify_one();
+}
+
+void ExportPipeline::restart() {
+    // Only capture() reads these, on the same thread; queued jobs of the old scene are still written
+    next_frame = next_field = -1;
+    static_done = false;
+}
+
+size_t ExportPipeline::writeFrame(const Job &job, std::vector<unsigned char> &rgba) {
+    rgba.resize(static_cast<size_t>(job.w) * job.h * 4);
+    colormap::mapField(job.data->data(), job.w, job.h, job.color_range, rgba.data());
+
+    char name[64];
+    if (conf.frame_format == "rgba") {
+        std::snprintf(name, sizeof(name), "/frame_%08lld_%dx%d.rgba", job.step, job.w, job.h);
+        std::ofstream ofs(conf.dir + name, std::ios::binary | std::ios::trunc);
+        ofs.write(reinterpret_cast<const char*>(rgba.data()), rgba.size());
+        if (!ofs) {
+            std::cerr << "Could not write frame " << conf.dir << name << "\n";
+            return 0;
+        }
+        return rgba.size();
+    }
+    std::snprintf(name, sizeof(name), "/frame_%08lld.png", job.step);
+    size_t bytes = 0;
+    return png::write(conf.dir + name, rgba.data(), job.w, job.h, conf.compress, &bytes) ? bytes : 0;
+}
+
+size_t ExportPipeline::writeField(const Job &job) {
+    FieldSnapshot snap;
+    snap.nx = job.w;
+    snap.ny = job.h;
+    snap.step = job.step;
+    for (int j0 = 0; j0 < job.h; j0 += conf.field_chunk_rows) {
+        const int j1 = std::min(job.h, j0 + conf.field_chunk_rows);
+        CheckpointSection section;
+        section.name = "Ez[" + std::to_string(j0) + ":" + std::to_string(j1) + "]";
+        section.data.assign(job.data->begin() + static_cast<size_t>(j0) * job.w,
+                            job.data->begin() + static_cast<size_t>(j1) * job.w);
+        snap.sections.push_back(std::move(section));
+    }
+    char name[64];
+    std::snprintf(name, sizeof(name), "/field_%08lld.em2f", job.step);
+    size_t bytes = 0;
+    return checkpoint::write(conf.dir + name, snap, conf.compress, &bytes) ? bytes : 0;
+}
+
+void ExportPipeline::workerLoop() {
+    std::vector<unsigned char> rgba;  // Per-worker scratch, reused across frames
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(m);
+            not_empty.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (queue.empty()) return;
+            job = std::move(queue.front());
+            queue.pop_front();
+        }
+        not_full.notify_one();
+
+        auto start = std::chrono::steady_clock::now();
+        // Writers return 0 on failure; only exports that reached disk are counted
+        const size_t frame_bytes = job.frame ? writeFrame(job, rgba) : 0;
+        const size_t field_bytes = job.field ? writeField(job) : 0;
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        buffers.release(std::move(job.data));
+
+        std::lock_guard<std::mutex> lock(m);
+        frames += frame_bytes > 0;
+        fields += field_bytes > 0;
+        failed += (job.frame && frame_bytes == 0) + (job.field && field_bytes == 0);
+        bytes_written += frame_bytes + field_bytes;
+        busy_s += seconds;
+    }
+}
+
+void ExportPipeline::finish() {
+    if (!enabled()) return;
+    {
+        std::lock_guard<std::mutex> lock(m);
+        stopping = true;
+    }
+    not_empty.notify_all();
+    for (auto &t : workers) t.join();
+    workers.clear();
+
+    const double wall_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - created).count();
+    const double mb = bytes_written / (1024.0 * 1024.0);
+    std::cout << "?? Export: " << frames << " frames, " << fields << " field snapshots, " << std::fixed
+              << std::setprecision(1) << mb << " MB to " << conf.dir << "/" << std::endl;
+    std::cout << "   Writer throughput " << (busy_s > 0.0 ? mb / busy_s : 0.0) << " MB/s per worker ("
+              << busy_s << " s busy of " << wall_s << " s), peak queue " << peak_depth << "/" << conf.queue_depth
+              << ", dropped " << dropped << ", failed " << failed << ", simulation blocked " << (1000.0 * blocked_s) << "ms"
+              << std::defaultfloat << std::setprecision(6) << std::endl;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Config.hpp"
+#include "ResourcePool.hpp"
+
+class FDTD;
+
+// Non-blocking export of colour-mapped frames and float field snapshots
+// capture() copies the display field once into a pooled buffer and queues it;
+// worker threads colour-map, encode and write. Only a full queue can stall the
+// caller (or drop the export, with drop_when_full). Frames are PNG or raw RGBA,
+// field snapshots use the checkpoint container with one section per row chunk.
+class ExportPipeline {
+public:
+    explicit ExportPipeline(const ExportConfig &conf);
+    ~ExportPipeline();
+    ExportPipeline(const ExportPipeline&) = delete;
+    ExportPipeline& operator=(const ExportPipeline&) = delete;
+
+    bool enabled() const { return conf.frame_interval > 0 || conf.field_interval > 0; }
+    void capture(const FDTD &sim, float color_range);  // Call once per simulation frame
+    void restart();                                    // The scene was rebuilt: export schedule starts over
+    void finish();                                     // Drains the queue and prints export statistics
+
+private:
+    struct Job {
+        long long step = 0;
+        int w = 0, h = 0;
+        float color_range = 1.0f;
+        bool frame = false, field = false;
+        std::unique_ptr<std::vector<float>> data;
+    };
+
+    ExportConfig conf;
+    std::deque<Job> queue;
+    std::mutex m;
+    std::condition_variable not_empty, not_full;
+    bool stopping = false;
+    std::vector<std::thread> workers;
+    ResourcePool<std::vector<float>> buffers;
+
+    long long next_frame = -1, next_field = -1;
+    bool static_done = false;
+
+    // Guarded by m
+    size_t frames = 0, fields = 0, dropped = 0, failed = 0, peak_depth = 0;
+    size_t bytes_written = 0;
+    double busy_s = 0.0;     // Summed worker time spent encoding and writing
+    double blocked_s = 0.0;  // Time capture() waited for queue space
+    std::chrono::steady_clock::time_point created;
+
+    static bool due(long long step, int interval, long long &next);
+    void workerLoop();
+    size_t writeFrame(const Job &job, std::vector<unsigned char> &rgba);
+    size_t writeField(const Job &job);
+};
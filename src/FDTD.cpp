@@ -1,9 +1,18 @@
 #include "FDTD.hpp"
+#include "Dipole.hpp"
+#include "Decomposition.hpp"
+#include "Checkpoint.hpp"
+#include "YeeSolver.hpp"
+#include "PinnedPool.hpp"
+#include "Probe.hpp"
+#include <atomic>
 #include <cmath>
 #include <algorithm>
 #include <iostream>
 #include <execution>
 #include <numeric>
+#include <iomanip>
+#include <chrono>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
@@ -13,8 +22,143 @@ const double mu0 = 4.0*M_PI*1e-7;
 const double c0 = 3e8;
 const double eps0 = 1.0/(mu0*c0*c0);
 
+// Field versions come from one process-wide counter, so a rebuilt or reused solver never repeats a
+// version an earlier scene published and consumers keyed on fieldVersion() always see the change
+static std::atomic<unsigned long long> field_versions{0};
+
+static unsigned long long nextFieldVersion() {
+    return field_versions.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+static GridConfig uniformGrid(int nx, int ny, double dx, double dy) {
+    GridConfig g;
+    g.nx = nx; g.ny = ny;
+    g.dx = dx; g.dy = dy;
+    return g;
+}
+
 FDTD::FDTD(int nx_, int ny_, double dx_, double dy_)
-: nx(nx_), ny(ny_), dx(dx_), dy(dy_) {
+: FDTD(uniformGrid(nx_, ny_, dx_, dy_)) {}
+
+FDTD::FDTD(const GridConfig &grid)
+: nx(grid.nx), ny(grid.ny), full_nx(grid.nx), full_ny(grid.ny), dx(grid.dx), dy(grid.dy) {
+    field_version = nextFieldVersion();
+    display_w = full_nx;
+    display_h = full_ny;
+    if (!parseSolverPrecision(grid.solver.precision, precision)) {
+        std::cout << "Unknown solver precision '" << grid.solver.precision << "' - using float" << std::endl;
+    }
+    if (!parseSolverKernel(grid.solver.kernel, kernel_policy)) {
+        std::cout << "Unknown solver kernel '" << grid.solver.kernel << "' - using threaded" << std::endl;
+    }
+    const bool custom_solver = precision != SolverPrecision::Float || kernel_policy != SolverKernel::Threaded;
+    if (kernel_policy == SolverKernel::Pinned) {
+        PinnedPool::configure({grid.solver.threads, grid.solver.numa_nodes, grid.solver.huge_pages});
+    }
+    if (grid.adaptive.enabled) {
+        // Static magnet field only: the quadtree stands in for the uniform grid and no Yee arrays are allocated
+        cells_x = full_nx;
+        cells_y = full_ny;
+        nx = ny = 0;
+        dt = 0.0;
+        quadtree = QuadtreeField(full_nx, full_ny, grid.adaptive);
+        display_w = quadtree.displayWidth();
+        display_h = quadtree.displayHeight();
+        if (grid.symmetry.x != "none" || grid.symmetry.y != "none" || !grid.mesh.refine.empty()) {
+            std::cout << "  Adaptive field ignores grid.symmetry and grid.mesh settings" << std::endl;
+        }
+        if (custom_solver) std::cout << "  Adaptive field ignores grid.solver settings" << std::endl;
+        return;
+    }
+
+    if (grid.out_of_core.enabled) {
+        // Uniform vacuum grid whose fields live in memory-mapped tile files instead of std::vector
+        out_of_core = true;
+        ooc_conf = grid.out_of_core;
+        cells_x = full_nx;
+        cells_y = full_ny;
+        mesh_x = MeshAxis(full_nx, dx, MeshConfig{}, true, false, false);
+        mesh_y = MeshAxis(full_ny, dy, MeshConfig{}, false, false, false);
+        dt = 0.99 / (c0 * std::sqrt(1.0/(dx*dx) + 1.0/(dy*dy)));
+
+        const double scale = std::min(1.0, static_cast<double>(std::max(ooc_conf.display_max, 16)) / std::max(nx, ny));
+        display_w = std::max(1, static_cast<int>(std::lround(nx * scale)));
+        display_h = std::max(1, static_cast<int>(std::lround(ny * scale)));
+
+        std::cout << "FDTD initialized out-of-core: " << nx << "x" << ny << " (" << (static_cast<double>(nx) * ny / 1e6)
+                  << "M points), dt=" << dt << ", preview " << display_w << "x" << display_h << std::endl;
+        if (grid.symmetry.x != "none" || grid.symmetry.y != "none" || !grid.mesh.refine.empty() || grid.pml_cells > 0) {
+            std::cout << "  Out-of-core fields ignore grid.symmetry, grid.mesh and CPML settings" << std::endl;
+        }
+        if (custom_solver) std::cout << "  Out-of-core fields ignore grid.solver settings" << std::endl;
+        tiled_ez.open(ooc_conf.path + ".ez", nx, ny, ooc_conf.tile, static_cast<size_t>(ooc_conf.resident_mb) << 20);
+        return;
+    }
+
+    if (grid.decomposition.ranks > 1 && DomainDecomposition::supported()) {
+        // Worker processes own the time-domain grid; this instance forwards the scene and gathers Ez
+        cells_x = full_nx;
+        cells_y = full_ny;
+        mesh_x = MeshAxis(full_nx, dx, MeshConfig{}, true, false, false);
+        mesh_y = MeshAxis(full_ny, dy, MeshConfig{}, false, false, false);
+        double dt_cfl = 1.0 / (c0 * std::sqrt(1.0/(dx*dx) + 1.0/(dy*dy)));
+        dt = 0.99 * dt_cfl;
+        decomposition = std::make_unique<DomainDecomposition>(grid, c0 * dt);
+        if (grid.symmetry.x != "none" || grid.symmetry.y != "none" || !grid.mesh.refine.empty() || grid.pml_cells > 0) {
+            std::cout << "  Decomposed runs ignore grid.symmetry, grid.mesh and CPML settings" << std::endl;
+        }
+        if (custom_solver) std::cout << "  Decomposed time-domain runs ignore grid.solver settings" << std::endl;
+        return;
+    }
+    if (grid.decomposition.ranks > 1) {
+        std::cout << "Domain decomposition is not supported on this platform - running in one process" << std::endl;
+    }
+
+    // Symmetry reduction: only the irreducible block is stored and stepped
+    sym_x = parseBoundary(grid.symmetry.x, grid.symmetry.period_x, full_nx);
+    sym_y = parseBoundary(grid.symmetry.y, grid.symmetry.period_y, full_ny);
+    auto reduced = [](Boundary b, int n, int period) {
+        if (b == Boundary::Periodic) return period;
+        if (b == Boundary::None) return n;
+        return n / 2 + 1; // Mirror plane (centre node of an odd n) is the last stored column/row
+    };
+    cells_x = reduced(sym_x, full_nx, grid.symmetry.period_x);
+    cells_y = reduced(sym_y, full_ny, grid.symmetry.period_y);
+
+    // Graded mesh over the irreducible block; uniform meshes keep one node per display cell
+    auto isMirror = [](Boundary b) { return b == Boundary::PEC || b == Boundary::PMC; };
+    mesh_x = MeshAxis(cells_x, dx, grid.mesh, true, isMirror(sym_x), sym_x == Boundary::Periodic);
+    mesh_y = MeshAxis(cells_y, dy, grid.mesh, false, isMirror(sym_y), sym_y == Boundary::Periodic);
+    nx = mesh_x.size();
+    ny = mesh_y.size();
+
+    // Display stencils: full display index -> reduced display coordinate -> mesh interpolation
+    auto buildMap = [](Boundary b, int n_full, int n, const MeshAxis &axis, DisplayMap &map) {
+        map.k0.resize(n_full);
+        map.k1.resize(n_full);
+        map.t.resize(n_full);
+        map.sign.assign(n_full, 1.0f);
+        const int plane = n - 1;
+        for (int k = 0; k < n_full; ++k) {
+            int r = k;
+            if (b == Boundary::Periodic) {
+                r = k % n;
+            } else if (b != Boundary::None && k > plane) {
+                r = 2 * plane - k;
+                if (b == Boundary::PEC) map.sign[k] = -1.0f;
+            }
+            axis.locate(r, map.k0[k], map.k1[k], map.t[k]);
+        }
+    };
+    buildMap(sym_x, full_nx, cells_x, mesh_x, col_map);
+    buildMap(sym_y, full_ny, cells_y, mesh_y, row_map);
+
+    // Periodic seams update every column/row; PMC planes update the plane itself
+    ez_i0 = sym_x == Boundary::Periodic ? 0 : 1;
+    ez_j0 = sym_y == Boundary::Periodic ? 0 : 1;
+    ez_i1 = (sym_x == Boundary::Periodic || sym_x == Boundary::PMC) ? nx : nx - 1;
+    ez_j1 = (sym_y == Boundary::Periodic || sym_y == Boundary::PMC) ? ny : ny - 1;
+
     // Reserve memory for better performance
     Ez.reserve(nx*ny);
     Hx.reserve(nx*ny);
@@ -26,31 +170,124 @@ FDTD::FDTD(int nx_, int ny_, double dx_, double dy_)
     Hy.assign(nx*ny, 0.0f);
     eps_r.assign(nx*ny, 1.0f);
 
-    // CFL stability condition
-    double dt_cfl = 1.0 / (c0 * std::sqrt(1.0/(dx*dx) + 1.0/(dy*dy)));
+    // CFL stability condition (set by the finest mesh spacing)
+    const double hx_min = mesh_x.minSpacing();
+    const double hy_min = mesh_y.minSpacing();
+    double dt_cfl = 1.0 / (c0 * std::sqrt(1.0/(hx_min*hx_min) + 1.0/(hy_min*hy_min)));
     dt = 0.99 * dt_cfl;
 
+    cez.assign(nx*ny, static_cast<float>(c0 * dt));
+    if (kernel_policy == SolverKernel::Pinned) {
+        // Re-fault every per-cell array row block by row block from the worker that will sweep it
+        PinnedPool &pool = PinnedPool::shared();
+        pool.firstTouch(Ez, ny, 0.0f);
+        pool.firstTouch(Hx, ny, 0.0f);
+        pool.firstTouch(Hy, ny, 0.0f);
+        pool.firstTouch(eps_r, ny, 1.0f);
+        pool.firstTouch(cez, ny, static_cast<float>(c0 * dt));
+    }
+    for (float inv : mesh_x.invNodeSpacing()) ch_hy.push_back(static_cast<float>(c0 * dt) * inv);
+    for (float inv : mesh_y.invNodeSpacing()) ch_hx.push_back(static_cast<float>(c0 * dt) * inv);
+    CPMLLayout layout;
+    layout.x_lo = sym_x != Boundary::Periodic;
+    layout.x_hi = sym_x == Boundary::None;
+    layout.y_lo = sym_y != Boundary::Periodic;
+    layout.y_hi = sym_y == Boundary::None;
+    layout.ez_i0 = ez_i0; layout.ez_i1 = ez_i1;
+    layout.ez_j0 = ez_j0; layout.ez_j1 = ez_j1;
+    cpml = CPML(mesh_x, mesh_y, dt, grid, layout);
+    for (int j = 0; j < ny; ++j) rows.push_back(j);
+
+    // Yee kernels for the configured precision and schedule; coefficients stay shared fp32 data
+    YeeLayout yee;
+    yee.nx = nx; yee.ny = ny;
+    yee.ez_i1 = ez_i1; yee.ez_j0 = ez_j0; yee.ez_j1 = ez_j1;
+    yee.wrap_x = ez_i0 == 0;
+    yee.periodic_x = sym_x == Boundary::Periodic; yee.pmc_x = sym_x == Boundary::PMC;
+    yee.periodic_y = sym_y == Boundary::Periodic; yee.pmc_y = sym_y == Boundary::PMC;
+    yee.cez = cez.data(); yee.ch_hx = ch_hx.data(); yee.ch_hy = ch_hy.data();
+    yee.inv_dx = mesh_x.invCellWidth().data(); yee.inv_dy = mesh_y.invCellWidth().data();
+    yee.rows = &rows;
+    yee.cpml = &cpml;
+    yee.ez = &Ez; yee.hx = &Hx; yee.hy = &Hy;
+    core = makeYeeCore(precision, kernel_policy, yee);
+    if (precision != SolverPrecision::Float) {
+        // The core owns the fields; Hx/Hy come back as fp32 copies only when somebody reads them
+        Hx.clear(); Hx.shrink_to_fit();
+        Hy.clear(); Hy.shrink_to_fit();
+    }
+    std::cout << "Solver kernels: " << core->precisionName() << "/" << core->kernelName()
+              << " (" << core->bytesPerCell() << " bytes/cell)" << std::endl;
+
     std::cout << "FDTD initialized: " << nx << "x" << ny << " (" << (nx*ny) << " points), dt=" << dt << std::endl;
+    if (isReduced()) {
+        std::cout << "Reduced domain: computing " << nx << "x" << ny << " nodes for the " << full_nx << "x" << full_ny
+                  << " domain (" << std::fixed << std::setprecision(2)
+                  << (static_cast<double>(full_nx) * full_ny / (static_cast<double>(nx) * ny)) << "x fewer cells)"
+                  << std::defaultfloat << std::endl;
+    }
     
     // Memory usage estimation
-    size_t total_memory = (Ez.capacity() + Hx.capacity() + Hy.capacity() + eps_r.capacity()) * sizeof(float);
+    size_t total_memory = (Ez.capacity() + Hx.capacity() + Hy.capacity() + eps_r.capacity() + cez.capacity()) * sizeof(float)
+                        + cpml.memoryBytes()
+                        + (precision != SolverPrecision::Float ? static_cast<size_t>(nx) * ny * core->bytesPerCell() : 0);
     std::cout << "Estimated memory usage: " << (total_memory / 1024 / 1024) << " MB" << std::endl;
 }
 
+FDTD::~FDTD() = default;
+
 void FDTD::reset() {
+    for (auto *field : {&tiled_ez, &tiled_hx, &tiled_hy}) {
+        if (!field->isOpen()) continue;
+        const size_t tile_len = static_cast<size_t>(field->tileSize()) * field->tileSize();
+        field->stream([tile_len](int, int, float *tile) { std::fill(tile, tile + tile_len, 0.0f); });
+    }
     std::fill(std::execution::par_unseq, Ez.begin(), Ez.end(), 0.0f);
     std::fill(std::execution::par_unseq, Hx.begin(), Hx.end(), 0.0f);
     std::fill(std::execution::par_unseq, Hy.begin(), Hy.end(), 0.0f);
+    if (core) core->reset();
     for (auto &s: sources) s.reset();
+    cpml.reset();
+    if (decomposition) decomposition->reset();
+    nstep = 0;
+    field_version = nextFieldVersion();
     std::cout << "FDTD reset with parallel algorithms" << std::endl;
 }
 
+void FDTD::clearScene() {
+    std::fill(eps_r.begin(), eps_r.end(), 1.0f);
+    std::fill(cez.begin(), cez.end(), static_cast<float>(c0 * dt));
+    sources.clear();
+    source_nodes.clear();
+    magnet_configs.clear();
+    static_field_ready = false;
+    reset();
+}
+
 void FDTD::addMaterialBlock(int x0, int y0, int w, int h, double er) {
     std::cout << "Adding material block at (" << x0 << "," << y0 << ") size " << w << "x" << h << " eps_r=" << er << std::endl;
-    for (int j = y0; j < y0 + h && j < ny; ++j) {
-        for (int i = x0; i < x0 + w && i < nx; ++i) {
-            if (i>=0 && j>=0)
+    if (quadtree.enabled()) {
+        std::cout << "  Adaptive field is magnet-only - material block ignored" << std::endl;
+        return;
+    }
+    if (out_of_core) {
+        std::cout << "  Out-of-core grid is vacuum only - material block ignored" << std::endl;
+        return;
+    }
+    if (decomposition) {
+        decomposition->addMaterialBlock({x0, y0, w, h, er});
+        return;
+    }
+    // Block covers the mesh nodes whose display position falls inside it
+    for (int j = 0; j < ny; ++j) {
+        const double y = mesh_y.position(j);
+        if (y < y0 || y >= y0 + h) continue;
+        for (int i = 0; i < nx; ++i) {
+            const double x = mesh_x.position(i);
+            if (x >= x0 && x < x0 + w) {
                 eps_r[idx(i,j)] = static_cast<float>(er);
+                cez[idx(i,j)] = static_cast<float>(c0 * dt / er);
+            }
         }
     }
 }
@@ -58,7 +295,68 @@ void FDTD::addMaterialBlock(int x0, int y0, int w, int h, double er) {
 void FDTD::addSource(const SourceConfig &sconf) {
     std::cout << "Adding source at (" << sconf.x << "," << sconf.y << ") type=" << sconf.type
               << " amplitude=" << sconf.amplitude << std::endl;
-    sources.emplace_back(sconf);
+    if (quadtree.enabled()) {
+        std::cout << "  Adaptive field is magnet-only - source ignored" << std::endl;
+        return;
+    }
+    if (out_of_core && !tiled_hx.isOpen()) {
+        const size_t limit = static_cast<size_t>(ooc_conf.resident_mb) << 20;
+        if (!tiled_hx.open(ooc_conf.path + ".hx", nx, ny, ooc_conf.tile, limit) ||
+            !tiled_hy.open(ooc_conf.path + ".hy", nx, ny, ooc_conf.tile, limit)) {
+            tiled_hx.close();
+            std::cout << "  Out-of-core H fields unavailable - source ignored" << std::endl;
+            return;
+        }
+    }
+    if (sconf.x < 0 || sconf.y < 0 || sconf.x >= full_nx || sconf.y >= full_ny) {
+        std::cout << "  Source lies outside the " << full_nx << "x" << full_ny << " domain - ignored" << std::endl;
+        return;
+    }
+    // Sources in the mirrored or repeated part drive their image inside the irreducible block;
+    // Ez is odd across PEC planes, so the image there has the opposite sign
+    SourceConfig image = sconf;
+    auto fold = [&](Boundary b, int n, int &k) {
+        if (k < n) return;
+        if (b == Boundary::Periodic) {
+            k %= n;
+        } else {
+            k = 2 * (n - 1) - k;
+            if (b == Boundary::PEC) image.amplitude = -image.amplitude;
+        }
+    };
+    fold(sym_x, cells_x, image.x);
+    fold(sym_y, cells_y, image.y);
+    if (image.x != sconf.x || image.y != sconf.y) {
+        std::cout << "  Source lies outside the irreducible region - driving its image at (" << image.x << ","
+                  << image.y << ") with amplitude " << image.amplitude << std::endl;
+    }
+    sources.emplace_back(image);
+    source_nodes.push_back(idx(mesh_x.nearest(image.x), mesh_y.nearest(image.y)));
+    if (decomposition) decomposition->addSource(sconf);
+}
+
+int FDTD::meshNode(int x, int y) const {
+    if (!core || x < 0 || y < 0 || x >= cells_x || y >= cells_y) return -1;
+    return idx(mesh_x.nearest(x), mesh_y.nearest(y));
+}
+
+void FDTD::gatherMesh(YeeField f, const std::vector<size_t> &nodes, float *out) const {
+    if (core && !nodes.empty()) core->gather(f, nodes.data(), nodes.size(), out);
+}
+
+void FDTD::keepVectorField(bool on) {
+    if (on == keep_vector) return;
+    keep_vector = on;
+    if (!on) {
+        Bx.clear(); Bx.shrink_to_fit();
+        By.clear(); By.shrink_to_fit();
+        return;
+    }
+    if (isTimeDomain() || quadtree.enabled() || out_of_core || isReduced()) {
+        std::cout << "Vector field needs an in-memory static field without symmetry reduction or mesh refinement" << std::endl;
+        return;
+    }
+    static_field_ready = false;
 }
 
 void FDTD::addMagnet(const MagnetConfig &mconf) {
@@ -66,15 +364,64 @@ void FDTD::addMagnet(const MagnetConfig &mconf) {
               << ") moment=(" << mconf.moment_x << "," << mconf.moment_y 
               << ") strength=" << mconf.strength << std::endl;
     magnet_configs.push_back(mconf);
+    static_field_ready = false;
+}
+
+bool FDTD::moveMagnet(size_t index, int x, int y) {
+    if (index >= magnet_configs.size()) return false;
+    std::vector<MagnetConfig> moved = magnet_configs;
+    moved[index].x = x;
+    moved[index].y = y;
+    setMagnets(moved);
+    return true;
+}
+
+void FDTD::setMagnets(const std::vector<MagnetConfig> &list) {
+    // An empty list falls back to the default pattern, which only a full evaluation sets up
+    bool local = !list.empty();
+    const size_t n = std::max(list.size(), magnet_configs.size());
+    for (size_t k = 0; k < n && local; ++k) {
+        const bool had = k < magnet_configs.size(), has = k < list.size();
+        if (had && has && magnet_configs[k] == list[k]) continue;
+        if (had) local = queueMagnetWindow(magnet_configs[k]);
+        if (has && local) local = queueMagnetWindow(list[k]);
+    }
+    magnet_configs = list;
+    if (!local) {
+        static_field_ready = false;
+        dirty_windows.clear();
+    }
+}
+
+bool FDTD::queueMagnetWindow(const MagnetConfig &magnet) {
+    // Symmetry images, refined meshes and the adaptive/out-of-core fields are always recomputed whole
+    if (!static_field_ready || isTimeDomain() || quadtree.enabled() || out_of_core || isReduced() || Ez.empty()) return false;
+    window_error += dipole::window_tolerance;
+    if (window_error > dipole::window_error_budget) return false;
+
+    const double r = dipole::influenceRadius(magnet, dipole::window_tolerance);
+    FieldWindow w;
+    w.i0 = static_cast<int>(std::clamp(std::floor(magnet.x - r), 0.0, static_cast<double>(nx)));
+    w.i1 = static_cast<int>(std::clamp(std::ceil(magnet.x + r) + 1.0, 0.0, static_cast<double>(nx)));
+    w.j0 = static_cast<int>(std::clamp(std::floor(magnet.y - r), 0.0, static_cast<double>(ny)));
+    w.j1 = static_cast<int>(std::clamp(std::ceil(magnet.y + r) + 1.0, 0.0, static_cast<double>(ny)));
+    if (w.i0 < w.i1 && w.j0 < w.j1) dirty_windows.push_back(w);
+
+    // Past half the grid a single full pass is cheaper than the windows
+    size_t area = 0;
+    for (const auto &d : dirty_windows) area += static_cast<size_t>(d.i1 - d.i0) * (d.j1 - d.j0);
+    return 2 * area <= static_cast<size_t>(nx) * ny;
 }
 
 void FDTD::applySources(int nstep) {
-    for (const auto &s : sources) {
+    for (size_t k = 0; k < sources.size(); ++k) {
+        const auto &s = sources[k];
+        if (source_nodes[k] < 0) continue;
         int i = s.conf.x;
         int j = s.conf.y;
-        if (i<0||i>=nx||j<0||j>=ny) continue;
         float val = s.value(static_cast<double>(nstep));
-        Ez[idx(i,j)] += val;
+        if (out_of_core) tiled_ez.at(source_nodes[k] % nx, source_nodes[k] / nx) += val;
+        else core->addEz(static_cast<size_t>(source_nodes[k]), val);
 
         // Reduced debug output for better performance
         if (nstep % 120 == 0 && nstep < 300) {
@@ -83,11 +430,399 @@ void FDTD::applySources(int nstep) {
     }
 }
 
+void FDTD::updateTiledH() {
+    const int T = tiled_ez.tileSize();
+    const int tiles_x = tiled_ez.tilesX(), tiles_y = tiled_ez.tilesY();
+    const float chy = static_cast<float>(c0 * dt) * static_cast<float>(1.0 / dx);
+    const float chx = static_cast<float>(c0 * dt) * static_cast<float>(1.0 / dy);
+    std::vector<int> cols(tiles_x);
+    std::iota(cols.begin(), cols.end(), 0);
+
+    // Tile rows in file order; row ty also reads the first Ez row of tile row ty+1, which is prefetched
+    for (int ty = 0; ty < tiles_y; ++ty) {
+        for (auto *field : {&tiled_ez, &tiled_hx, &tiled_hy}) field->prefetchRow(ty + 1);
+        std::for_each(std::execution::par, cols.begin(), cols.end(), [&](int tx) {
+            const float *ez = tiled_ez.tile(tx, ty);
+            const float *ez_right = tx + 1 < tiles_x ? tiled_ez.tile(tx + 1, ty) : nullptr;
+            const float *ez_below = ty + 1 < tiles_y ? tiled_ez.tile(tx, ty + 1) : nullptr;
+            float *hx = tiled_hx.tile(tx, ty);
+            float *hy = tiled_hy.tile(tx, ty);
+            const int w = std::min(T, nx - tx * T);
+            const int h = std::min(T, ny - ty * T);
+            const bool has_right = tx * T + w < nx;
+            for (int jj = 0; jj < h; ++jj) {
+                const size_t row = static_cast<size_t>(jj) * T;
+                for (int ii = 0; ii + 1 < w; ++ii) hy[row + ii] += chy * (ez[row + ii + 1] - ez[row + ii]);
+                if (has_right) hy[row + w - 1] += chy * (ez_right[row] - ez[row + w - 1]);
+                if (ty * T + jj + 1 < ny) {
+                    const float *ez1 = jj + 1 < h ? &ez[row + T] : ez_below;
+                    for (int ii = 0; ii < w; ++ii) hx[row + ii] -= chx * (ez1[ii] - ez[row + ii]);
+                }
+            }
+        });
+        tiled_ez.releaseRow(ty - 1);
+        tiled_hx.releaseRow(ty);
+        tiled_hy.releaseRow(ty);
+    }
+    tiled_ez.releaseRow(tiles_y - 1);
+}
+
+void FDTD::updateTiledE() {
+    const int T = tiled_ez.tileSize();
+    const int tiles_x = tiled_ez.tilesX(), tiles_y = tiled_ez.tilesY();
+    const float ce = static_cast<float>(c0 * dt);
+    const float inv_dx = static_cast<float>(1.0 / dx);
+    const float inv_dy = static_cast<float>(1.0 / dy);
+    std::vector<int> cols(tiles_x);
+    std::iota(cols.begin(), cols.end(), 0);
+
+    // Row ty reads the last Hx row of tile row ty-1 and the last Hy column of the tile to the left
+    for (int ty = 0; ty < tiles_y; ++ty) {
+        for (auto *field : {&tiled_ez, &tiled_hx, &tiled_hy}) field->prefetchRow(ty + 1);
+        std::for_each(std::execution::par, cols.begin(), cols.end(), [&](int tx) {
+            float *ez = tiled_ez.tile(tx, ty);
+            const float *hx = tiled_hx.tile(tx, ty);
+            const float *hy = tiled_hy.tile(tx, ty);
+            const float *hy_left = tx > 0 ? tiled_hy.tile(tx - 1, ty) : nullptr;
+            const float *hx_above = ty > 0 ? tiled_hx.tile(tx, ty - 1) : nullptr;
+
+            // Outer ring stays zero (PEC walls), as in the in-core kernel
+            const int i0 = tx == 0 ? 1 : 0, i1 = std::min(T, nx - 1 - tx * T);
+            const int j0 = ty == 0 ? 1 : 0, j1 = std::min(T, ny - 1 - ty * T);
+            for (int jj = j0; jj < j1; ++jj) {
+                const size_t row = static_cast<size_t>(jj) * T;
+                const float *hx0 = jj > 0 ? &hx[row - T] : &hx_above[static_cast<size_t>(T - 1) * T];
+                int ii = i0;
+                if (ii == 0 && i1 > 0) {
+                    ez[row] += ce * ((hy[row] - hy_left[row + T - 1]) * inv_dx - (hx[row] - hx0[0]) * inv_dy);
+                    ii = 1;
+                }
+                for (; ii < i1; ++ii) {
+                    ez[row + ii] += ce * ((hy[row + ii] - hy[row + ii - 1]) * inv_dx - (hx[row + ii] - hx0[ii]) * inv_dy);
+                }
+            }
+        });
+        tiled_ez.releaseRow(ty);
+        tiled_hy.releaseRow(ty);
+        tiled_hx.releaseRow(ty - 1);
+    }
+    tiled_hx.releaseRow(tiles_y - 1);
+}
+
+FDTD::Boundary FDTD::parseBoundary(const std::string &name, int period, int n) {
+    if (name == "pec" || name == "pmc") {
+        // The plane is the centre node, so the two halves only match up for an odd node count
+        if (n % 2 == 1) return name == "pec" ? Boundary::PEC : Boundary::PMC;
+        std::cout << "Ignoring " << name << " symmetry: mirror planes need an odd cell count (" << n
+                  << " is even - use " << n + 1 << ")" << std::endl;
+    } else if (name == "periodic") {
+        if (period >= 4 && period <= n) return Boundary::Periodic;
+        std::cout << "Ignoring periodic symmetry: period " << period << " must be in [4, " << n << "]" << std::endl;
+    } else if (name != "none") {
+        std::cout << "Unknown symmetry '" << name << "' - expected none, pec, pmc or periodic" << std::endl;
+    }
+    return Boundary::None;
+}
+
+std::vector<MagnetConfig> FDTD::symmetryMagnets() const {
+    std::vector<MagnetConfig> field_magnets;
+    const bool per_x = sym_x == Boundary::Periodic;
+    const bool per_y = sym_y == Boundary::Periodic;
+
+    // Periodic axes: the unit-cell magnets plus their images across the full extent
+    const int tiles_x = per_x ? full_nx / cells_x + 1 : 0;
+    const int tiles_y = per_y ? full_ny / cells_y + 1 : 0;
+    int outside = 0;
+    for (const auto &m : magnet_configs) {
+        if ((per_x && (m.x < 0 || m.x >= cells_x)) || (per_y && (m.y < 0 || m.y >= cells_y))) {
+            ++outside;
+            continue;
+        }
+        for (int ty = -tiles_y; ty <= tiles_y; ++ty) {
+            for (int tx = -tiles_x; tx <= tiles_x; ++tx) {
+                MagnetConfig image = m;
+                image.x += tx * cells_x;
+                image.y += ty * cells_y;
+                field_magnets.push_back(image);
+            }
+        }
+    }
+    if (outside > 0) {
+        std::cout << "  Periodic symmetry: ignoring " << outside << " magnets outside the unit cell" << std::endl;
+    }
+
+    // Mirror axes: the configured layout must already be symmetric about the plane. The partner's
+    // moment is the image dipole: normal component reversed at a PEC plane (normal B = 0),
+    // tangential component reversed at a PMC plane (tangential B = 0)
+    auto hasPartner = [&](const MagnetConfig &m, bool mirror_x, Boundary b) {
+        const int px = mirror_x ? 2 * (cells_x - 1) - m.x : m.x;
+        const int py = mirror_x ? m.y : 2 * (cells_y - 1) - m.y;
+        const bool flip_x = mirror_x == (b == Boundary::PEC);
+        const double mx = flip_x ? -m.moment_x : m.moment_x;
+        const double my = flip_x ? m.moment_y : -m.moment_y;
+        return std::any_of(magnet_configs.begin(), magnet_configs.end(), [&](const MagnetConfig &o) {
+            return o.x == px && o.y == py && std::abs(o.strength - m.strength) < 1e-9 &&
+                   std::abs(o.moment_x - mx) < 1e-9 && std::abs(o.moment_y - my) < 1e-9;
+        });
+    };
+    for (int axis = 0; axis < 2; ++axis) {
+        const Boundary b = axis == 0 ? sym_x : sym_y;
+        if (b != Boundary::PEC && b != Boundary::PMC) continue;
+        const auto unpaired = std::count_if(magnet_configs.begin(), magnet_configs.end(),
+                                            [&](const MagnetConfig &m) { return !hasPartner(m, axis == 0, b); });
+        if (unpaired > 0) {
+            std::cout << "  WARNING: " << unpaired << " magnets have no mirror partner about the "
+                      << (axis == 0 ? "x" : "y") << " centre line (position, strength and mirrored moment)"
+                      << " - reduced field differs from a full solve" << std::endl;
+        }
+    }
+    return per_x || per_y ? field_magnets : magnet_configs;
+}
+
+const std::vector<float>& FDTD::getEz() const {
+    if (decomposition && isTimeDomain()) {
+        if (expanded_version != field_version) {
+            decomposition->gather(Ez_full);
+            expanded_version = field_version;
+        }
+        return Ez_full;
+    }
+    if (out_of_core) {
+        if (expanded_version != field_version) {
+            tiled_ez.downsample(Ez_full, display_w, display_h);
+            expanded_version = field_version;
+        }
+        return Ez_full;
+    }
+    if (quadtree.enabled()) {
+        if (expanded_version != field_version) {
+            quadtree.rasterize(Ez_full, quadtree.displayWidth(), quadtree.displayHeight());
+            expanded_version = field_version;
+        }
+        return Ez_full;
+    }
+    const std::vector<float> &mesh_ez = meshEz();
+    if (!isReduced()) return mesh_ez;
+
+    // Rebuild the uniform full-domain field only when the solution changed since the last request:
+    // bilinear resampling from the mesh, then reflection/tiling of the irreducible block
+    if (expanded_version != field_version) {
+        Ez_full.resize(static_cast<size_t>(full_nx) * full_ny);
+        const bool odd = isTimeDomain(); // Static |B| pattern is reflection-invariant
+        std::vector<int> full_rows(full_ny);
+        std::iota(full_rows.begin(), full_rows.end(), 0);
+        std::for_each(std::execution::par_unseq, full_rows.begin(), full_rows.end(), [&](int J) {
+            const int j0 = row_map.k0[J];
+            const float *src0 = &mesh_ez[static_cast<size_t>(j0) * nx];
+            const float *src1 = &mesh_ez[static_cast<size_t>(row_map.k1[J]) * nx];
+            const float ty = row_map.t[J];
+            const float rs = odd ? row_map.sign[J] : 1.0f;
+            float *dst = &Ez_full[J * full_nx];
+            for (int I = 0; I < full_nx; ++I) {
+                const int i0 = col_map.k0[I], i1 = col_map.k1[I];
+                const float tx = col_map.t[I];
+                const float v0 = src0[i0] + tx * (src0[i1] - src0[i0]);
+                const float v1 = src1[i0] + tx * (src1[i1] - src1[i0]);
+                dst[I] = (v0 + ty * (v1 - v0)) * (odd ? rs * col_map.sign[I] : 1.0f);
+            }
+        });
+        expanded_version = field_version;
+    }
+    return Ez_full;
+}
+
+const std::vector<float>& FDTD::meshEz() const {
+    return core && isTimeDomain() ? core->floatField(YeeField::Ez) : Ez;
+}
+
+const std::vector<float>& FDTD::meshHx() const {
+    return core ? core->floatField(YeeField::Hx) : Hx;
+}
+
+const std::vector<float>& FDTD::meshHy() const {
+    return core ? core->floatField(YeeField::Hy) : Hy;
+}
+
+uint64_t FDTD::stateFingerprint() const {
+    // Everything a resumed run must share with the checkpointed one for a bit-exact continuation
+    uint64_t h = checkpoint::fnv1a(&nx, sizeof(nx));
+    h = checkpoint::fnv1a(&ny, sizeof(ny), h);
+    h = checkpoint::fnv1a(&dt, sizeof(dt), h);
+    const int npml = cpml.thickness();
+    h = checkpoint::fnv1a(&npml, sizeof(npml), h);
+    h = checkpoint::fnv1a(cez.data(), cez.size() * sizeof(float), h);
+    h = checkpoint::fnv1a(ch_hx.data(), ch_hx.size() * sizeof(float), h);
+    h = checkpoint::fnv1a(ch_hy.data(), ch_hy.size() * sizeof(float), h);
+    for (size_t k = 0; k < sources.size(); ++k) {
+        const SourceConfig &c = sources[k].conf;
+        const double params[] = {c.amplitude, c.t0, c.spread, c.freq_hz};
+        h = checkpoint::fnv1a(c.type.data(), c.type.size(), h);
+        h = checkpoint::fnv1a(params, sizeof(params), h);
+        h = checkpoint::fnv1a(&source_nodes[k], sizeof(int), h);
+    }
+    if (precision != SolverPrecision::Float) {
+        // Field sections hold the raw storage, so only a run at the same precision can resume them
+        const std::string name = solverPrecisionName(precision);
+        h = checkpoint::fnv1a(name.data(), name.size(), h);
+    }
+    return h;
+}
+
+bool FDTD::snapshot(FieldSnapshot &out) const {
+    if (!isTimeDomain() || out_of_core || decomposition || quadtree.enabled()) return false;
+    const auto aux = cpml.auxiliaryFields();
+    out.nx = nx;
+    out.ny = ny;
+    out.step = nstep;
+    out.fingerprint = stateFingerprint();
+    out.sections.resize(3 + aux.size());
+    const char *names[] = {"Ez", "Hx", "Hy"};
+    for (size_t k = 0; k < out.sections.size(); ++k) {
+        out.sections[k].name = k < 3 ? names[k] : "cpml" + std::to_string(k - 3);
+        if (k < 3) core->pack(static_cast<YeeField>(k), out.sections[k].data);
+        else out.sections[k].data.assign(aux[k - 3]->begin(), aux[k - 3]->end());
+    }
+    return true;
+}
+
+bool FDTD::restore(const FieldSnapshot &in) {
+    if (!isTimeDomain() || out_of_core || decomposition || quadtree.enabled()) {
+        std::cout << "Restart needs an in-core time-domain run - checkpoint ignored" << std::endl;
+        return false;
+    }
+    if (in.nx != nx || in.ny != ny || in.fingerprint != stateFingerprint()) {
+        std::cout << "Checkpoint was written for a different grid, material or source setup ("
+                  << in.nx << "x" << in.ny << ") - starting from step 0" << std::endl;
+        return false;
+    }
+    const auto aux = cpml.auxiliaryFields();
+    if (in.sections.size() != 3 + aux.size()) return false;
+    for (size_t k = 0; k < in.sections.size(); ++k) {
+        const bool fits = k < 3 ? core->unpack(static_cast<YeeField>(k), in.sections[k].data)
+                                : in.sections[k].data.size() == aux[k - 3]->size();
+        if (!fits) {
+            std::cout << "Checkpoint section '" << in.sections[k].name << "' has the wrong size - starting from step 0" << std::endl;
+            reset();
+            return false;
+        }
+        if (k >= 3) std::copy(in.sections[k].data.begin(), in.sections[k].data.end(), aux[k - 3]->begin());
+    }
+    nstep = static_cast<int>(in.step);
+    field_version = nextFieldVersion();
+    std::cout << "Restored checkpoint state at step " << nstep << std::endl;
+    return true;
+}
+
+bool FDTD::advance(int steps) {
+    if (decomposition && isTimeDomain()) {
+        if (!decomposition->advance(steps)) return false;
+        nstep += std::max(steps, 0);
+        field_version = nextFieldVersion();
+        return true;
+    }
+    for (int s = 0; s < steps; ++s) step();
+    return true;
+}
+
+template <typename Real>
+void FDTD::computeStaticField(const std::vector<MagnetConfig> &field_magnets, const FieldWindow &window) {
+    // Magnets are converted once; every row runs against the precomputed node positions.
+    // Points are evaluated independently, so a window matches the same points of a full pass.
+    const std::vector<dipole::Pole<Real>> poles = dipole::poles<Real>(field_magnets);
+    std::vector<double> xs(nx);
+    for (int i = 0; i < nx; ++i) xs[i] = mesh_x.position(i);
+    const int i0 = window.i0, w = window.i1 - window.i0;
+    const bool vector = !Bx.empty();
+    auto vectorRow = [&](int j, std::vector<Real> &scratch) {
+        const size_t row = static_cast<size_t>(j) * nx + i0;
+        dipole::vectorRow<Real, true>(&Bx[row], &By[row], &xs[i0], w, mesh_y.position(j), poles, scratch);
+    };
+
+    if (kernel_policy == SolverKernel::Threaded) {
+        std::vector<int> field_rows(window.j1 - window.j0);  // Decomposed static scenes have no solver rows
+        std::iota(field_rows.begin(), field_rows.end(), window.j0);
+        std::for_each(std::execution::par, field_rows.begin(), field_rows.end(), [&](int j) {
+            thread_local std::vector<Real> scratch;
+            dipole::row<Real, true>(&Ez[static_cast<size_t>(j) * nx + i0], &xs[i0], w, mesh_y.position(j), poles, scratch);
+            if (vector) vectorRow(j, scratch);
+        });
+        return;
+    }
+    if (kernel_policy == SolverKernel::Pinned) {
+        PinnedPool::shared().forRows(ny, window.j0, window.j1, [&](int j) {
+            thread_local std::vector<Real> scratch;
+            dipole::row<Real, true>(&Ez[static_cast<size_t>(j) * nx + i0], &xs[i0], w, mesh_y.position(j), poles, scratch);
+            if (vector) vectorRow(j, scratch);
+        });
+        return;
+    }
+
+    // Single-threaded kernels keep the progress report for large computations (full passes only)
+    const int rows_total = window.j1 - window.j0;
+    const size_t total_points = static_cast<size_t>(w) * rows_total;
+    const int progress_rows = std::max(1, rows_total / 20); // Report every 5%
+    const bool report = w == nx && rows_total == ny;
+    std::vector<Real> scratch;
+    for (int j = window.j0; j < window.j1; ++j) {
+        float *out = &Ez[static_cast<size_t>(j) * nx + i0];
+        if (kernel_policy == SolverKernel::Simd) dipole::row<Real, true>(out, &xs[i0], w, mesh_y.position(j), poles, scratch);
+        else dipole::row<Real, false>(out, &xs[i0], w, mesh_y.position(j), poles, scratch);
+        if (vector) vectorRow(j, scratch);
+        if ((j - window.j0 + 1) % progress_rows == 0 && report) {
+            const size_t points_computed = static_cast<size_t>(j - window.j0 + 1) * w;
+            std::cout << "Progress: " << (points_computed * 100 / total_points) << "% (" << points_computed
+                      << "/" << total_points << " points)" << std::endl;
+        }
+    }
+}
+
 void FDTD::step() {
-    static bool initialized = false;
+    if (isTimeDomain() && decomposition) {
+        advance(1);
+        return;
+    }
+    if (isTimeDomain() && out_of_core) {
+        updateTiledH();
+        updateTiledE();
+        applySources(nstep);
+        ++nstep;
+        field_version = nextFieldVersion();
+        return;
+    }
+    if (isTimeDomain()) {
+        core->step();
+        applySources(nstep);
+        ++nstep;
+        field_version = nextFieldVersion();
+        if (probes) probes->sample(*this);
+        return;
+    }
+    
+    if (static_field_ready && !dirty_windows.empty()) {
+        // Only the neighbourhoods of edited magnets changed by more than dipole::window_tolerance
+        auto window_start = std::chrono::high_resolution_clock::now();
+        const std::vector<MagnetConfig> field_magnets = symmetryMagnets();
+        const bool in_double = precision == SolverPrecision::Double;
+        size_t points = 0;
+        for (const auto &w : dirty_windows) {
+            if (in_double) computeStaticField<double>(field_magnets, w);
+            else computeStaticField<float>(field_magnets, w);
+            points += static_cast<size_t>(w.i1 - w.i0) * (w.j1 - w.j0);
+        }
+        const double s = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - window_start).count();
+        std::cout << "Updated " << dirty_windows.size() << " local field window(s), " << points << " points in "
+                  << 1000.0 * s << "ms (error bound outside " << window_error << ")" << std::endl;
+        dirty_windows.clear();
+        field_version = nextFieldVersion();
+        return;
+    }
     
-    if (!initialized) {
+    if (!static_field_ready) {
         std::cout << "Computing ultra-high resolution magnetic field pattern from configured magnets..." << std::endl;
+        dirty_windows.clear();
+        window_error = 0.0;
+        
+        if (decomposition && Ez.empty()) Ez.assign(static_cast<size_t>(nx) * ny, 0.0f); // Static scenes stay in-process
         
         // Clear the field first with parallel algorithm
         std::fill(std::execution::par_unseq, Ez.begin(), Ez.end(), 0.0f);
@@ -96,11 +831,11 @@ void FDTD::step() {
             std::cout << "No magnets configured - using optimized default pattern" << std::endl;
             // Enhanced fallback pattern for high resolution
             std::vector<MagnetConfig> default_magnets = {
-                {nx/2, ny/2, 0.0, 1.0, 2.5, "center_north_primary"},
-                {nx/3, ny/2, 0.0, -1.0, 2.0, "left_south_primary"},
-                {2*nx/3, ny/2, 0.0, -1.0, 2.0, "right_south_primary"},
-                {nx/2, ny/3, 1.0, 0.0, 1.8, "top_east_secondary"},
-                {nx/2, 2*ny/3, -1.0, 0.0, 1.8, "bottom_west_secondary"}
+                {full_nx/2, full_ny/2, 0.0, 1.0, 2.5, "center_north_primary"},
+                {full_nx/3, full_ny/2, 0.0, -1.0, 2.0, "left_south_primary"},
+                {2*full_nx/3, full_ny/2, 0.0, -1.0, 2.0, "right_south_primary"},
+                {full_nx/2, full_ny/3, 1.0, 0.0, 1.8, "top_east_secondary"},
+                {full_nx/2, 2*full_ny/3, -1.0, 0.0, 1.8, "bottom_west_secondary"}
             };
             magnet_configs = default_magnets;
         }
@@ -111,88 +846,56 @@ void FDTD::step() {
                       << ") strength=" << magnet.strength << std::endl;
         }
         
-        // Pre-compute constants for better performance
-        const float scale_factor = 80.0f; // Optimized scaling for high-resolution visualization
-        const float min_distance_sq = 4.0f;
-        const float field_clamp_min = -5.0f;
-        const float field_clamp_max = 5.0f;
-        
-        // Progress reporting for large computations
-        const int total_points = nx * ny;
-        const size_t progress_interval = static_cast<size_t>(total_points) / 20; // Report every 5%
-        size_t points_computed = 0;
+        if (quadtree.enabled()) {
+            quadtree.build(magnet_configs);
+            static_field_ready = true;
+            field_version = nextFieldVersion();
+            return;
+        }
         
-        std::cout << "Computing " << total_points << " field points..." << std::endl;
+        // Magnets seen by the irreducible region (periodic images included)
+        const std::vector<MagnetConfig> field_magnets = symmetryMagnets();
         
-        // Optimized field computation with better algorithms
-        for (int j = 0; j < ny; ++j) {
-            for (int i = 0; i < nx; ++i) {
-                float total_field = 0.0f;
-                
-                // Vectorized computation for all magnetic dipoles
-                for (const auto& magnet : magnet_configs) {
-                    const float dx_val = static_cast<float>(i - magnet.x);
-                    const float dy_val = static_cast<float>(j - magnet.y);
-                    const float r_sq = dx_val*dx_val + dy_val*dy_val;
-                    
-                    if (r_sq > min_distance_sq) {
-                        // Optimized magnetic dipole field calculation
-                        const float r = std::sqrt(r_sq);
-                        const float r_inv = 1.0f / r;
-                        const float r_inv3 = r_inv * r_inv * r_inv;
-                        
-                        // Unit vector from dipole to field point
-                        const float rx = dx_val * r_inv;
-                        const float ry = dy_val * r_inv;
-                        
-                        // Magnetic dipole moment components
-                        const float mx = static_cast<float>(magnet.moment_x);
-                        const float my = static_cast<float>(magnet.moment_y);
-                        
-                        // Dot product: m?r?
-                        const float m_dot_r = mx * rx + my * ry;
-                        
-                        // Optimized magnetic field components: B = (3(m?r?)r? - m?)/r
-                        const float Bx = (3.0f * m_dot_r * rx - mx) * r_inv3;
-                        const float By = (3.0f * m_dot_r * ry - my) * r_inv3;
-                        
-                        // Field magnitude with optimized square root
-                        const float field_magnitude = std::sqrt(Bx*Bx + By*By);
-                        
-                        // Add contribution with strength weighting
-                        total_field += static_cast<float>(magnet.strength) * field_magnitude * scale_factor;
-                        
-                    } else {
-                        // Enhanced pole field calculation for magnet locations
-                        float pole_strength = 0.0f;
-                        const float abs_mx = std::abs(static_cast<float>(magnet.moment_x));
-                        const float abs_my = std::abs(static_cast<float>(magnet.moment_y));
-                        
-                        if (abs_my > abs_mx) {
-                            // Primarily vertical orientation
-                            pole_strength = static_cast<float>(magnet.moment_y) > 0 ? 4.0f : -4.0f;
-                        } else {
-                            // Primarily horizontal orientation  
-                            pole_strength = static_cast<float>(magnet.moment_x) > 0 ? 4.0f : -4.0f;
+        if (out_of_core) {
+            // Stream the dipole evaluation through the mapped tiles, writing results in place
+            if (tiled_ez.isOpen()) {
+                const int T = tiled_ez.tileSize();
+                const auto poles = dipole::poles<float>(field_magnets);
+                auto stream_start = std::chrono::high_resolution_clock::now();
+                tiled_ez.stream([&](int tx, int ty, float *tile) {
+                    const int w = std::min(T, nx - tx * T);
+                    const int h = std::min(T, ny - ty * T);
+                    for (int jj = 0; jj < h; ++jj) {
+                        for (int ii = 0; ii < w; ++ii) {
+                            tile[jj * T + ii] = dipole::field<float>(tx * T + ii, ty * T + jj, poles);
                         }
-                        
-                        total_field += static_cast<float>(magnet.strength) * pole_strength;
                     }
-                }
-                
-                // Enhanced field clamping for better visualization
-                total_field = std::clamp(total_field, field_clamp_min, field_clamp_max);
-                Ez[idx(i,j)] = total_field;
-                
-                // Progress reporting for large computations
-                points_computed++;
-                if (points_computed % progress_interval == 0) {
-                    int progress_percent = (points_computed * 100) / total_points;
-                    std::cout << "Progress: " << progress_percent << "% (" << points_computed 
-                              << "/" << total_points << " points)" << std::endl;
-                }
+                });
+                const double s = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - stream_start).count();
+                std::cout << "? Out-of-core field streamed in " << s << "s: "
+                          << (static_cast<double>(nx) * ny / 1e6 / s) << " Mpoints/s, "
+                          << (tiled_ez.bytes() / (1024.0 * 1024.0) / s) << " MB/s written" << std::endl;
             }
+            static_field_ready = true;
+            field_version = nextFieldVersion();
+            return;
+        }
+        
+        const int total_points = nx * ny;
+        if (keep_vector && !isReduced()) {
+            Bx.assign(static_cast<size_t>(nx) * ny, 0.0f);
+            By.assign(static_cast<size_t>(nx) * ny, 0.0f);
         }
+        // Half precision only changes field storage; the static field is evaluated in fp32 like the default
+        const SolverPrecision eval = precision == SolverPrecision::Double ? precision : SolverPrecision::Float;
+        std::cout << "Computing " << total_points << " field points (" << solverPrecisionName(eval) << "/"
+                  << solverKernelName(kernel_policy) << " kernels)..." << std::endl;
+        auto eval_start = std::chrono::high_resolution_clock::now();
+        const FieldWindow all{0, 0, nx, ny};
+        if (eval == SolverPrecision::Double) computeStaticField<double>(field_magnets, all);
+        else computeStaticField<float>(field_magnets, all);
+        const double eval_s = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - eval_start).count();
+        std::cout << "   Evaluated in " << eval_s << "s (" << (total_points / 1e6 / std::max(eval_s, 1e-9)) << " Mpoints/s)" << std::endl;
         
         // Compute field statistics for quality assessment
         auto minmax = std::minmax_element(Ez.begin(), Ez.end());
@@ -212,7 +915,8 @@ void FDTD::step() {
         std::cout << "   Magnets: " << magnet_configs.size() << " configured" << std::endl;
         std::cout << "   Resolution: " << nx << "" << ny << " for maximum detail visualization" << std::endl;
         
-        initialized = true;
+        static_field_ready = true;
+        field_version = nextFieldVersion();
     }
     
     // Static field - no time evolution needed for magnetic visualization
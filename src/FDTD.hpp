@@ -2,9 +2,22 @@
 
 #include <vector>
 #include <cstddef>
+#include <memory>
 #include <cmath>
+#include <cstdint>
 #include <iostream>
 #include "Config.hpp"
+#include "CPML.hpp"
+#include "Mesh.hpp"
+#include "Quadtree.hpp"
+#include "TiledField.hpp"
+#include "SolverPolicy.hpp"
+
+class DomainDecomposition;
+class YeeCore;
+class ProbeSet;
+struct FieldSnapshot;
+enum class YeeField;
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
@@ -47,21 +60,93 @@ public:
 
 // Finite-Difference Time-Domain (FDTD) Solver
 // Solves Maxwell's equations for electromagnetic field propagation
-// in heterogeneous media with arbitrary scalar source distributions
+// in heterogeneous media with arbitrary scalar source distributions.
+// Without sources the solver only evaluates the static magnet field;
+// with sources every step() advances the TMz Yee grid by one dt.
 class FDTD {
 public:
     FDTD(int nx, int ny, double dx, double dy);
+    explicit FDTD(const GridConfig &grid);
+    ~FDTD();
     void reset();
+    void clearScene();        // Drops materials, sources and magnets so the instance can be reused
     void step();
+    bool advance(int steps);  // Several time steps; decomposed runs issue them to the workers in one batch.
+                              // False when a decomposed run has failed and the field did not move.
+
+    bool isTimeDomain() const { return !sources.empty(); }
+    int getStep() const { return nstep; }
+    unsigned long long fieldVersion() const { return field_version; }  // Changes whenever the field does; unique per process
 
     void addMaterialBlock(int x0, int y0, int w, int h, double eps_r);
     void addSource(const SourceConfig &sconf);
     void addMagnet(const MagnetConfig &mconf); // New: add magnet configuration
+    bool moveMagnet(size_t index, int x, int y);  // The static field is updated on the next step()
+    // Replaces the magnet set. While an in-memory static field is current, each changed magnet only
+    // queues the windows around its old and new placement (see dipole::window_tolerance) and the next
+    // step() re-evaluates just those; otherwise the whole field is recomputed.
+    void setMagnets(const std::vector<MagnetConfig> &list);
+    const std::vector<MagnetConfig>& magnets() const { return magnet_configs; }
+
+    // Checkpoint/restart of the in-core time-domain state; false for adaptive, out-of-core and decomposed runs.
+    // snapshot() reuses the capacity of `out`, restore() rejects state from a different grid or scene.
+    bool snapshot(FieldSnapshot &out) const;
+    bool restore(const FieldSnapshot &in);
+
+    // Full-domain field; symmetry-reduced, adaptive and out-of-core runs rebuild it lazily on request
+    const std::vector<float>& getEz() const;
+    int displayWidth() const { return display_w; }
+    int displayHeight() const { return display_h; }
+    // Solver-mesh buffers (meshWidth() x meshHeight(), row-major); empty when the grid is not held in memory
+    const std::vector<float>& meshHx() const;
+    const std::vector<float>& meshHy() const;
+    const std::vector<float>& meshEpsR() const { return eps_r; }
+    int meshWidth() const { return nx; }
+    int meshHeight() const { return ny; }
+    bool isAdaptive() const { return quadtree.enabled(); }
+    bool isOutOfCore() const { return out_of_core; }
+    bool isDecomposed() const { return decomposition != nullptr; }
+    SolverPrecision solverPrecision() const { return precision; }
+    SolverKernel solverKernel() const { return kernel_policy; }
+    bool isReduced() const {
+        return cells_x != full_nx || cells_y != full_ny || !mesh_x.isUniform() || !mesh_y.isUniform();
+    }
 
-    const std::vector<float>& getEz() const { return Ez; }
+    // Probes: sampled after every in-memory time step while attached (nullptr detaches).
+    // meshNode() is the node nearest a display cell of the irreducible region, -1 outside it or
+    // without an in-memory grid; cellWidthX/Y() are physical dual-cell widths in metres.
+    void attachProbes(ProbeSet *set) { probes = set; }
+    int meshNode(int x, int y) const;
+    int meshColumn(int node) const { return node % nx; }
+    int meshRow(int node) const { return node / nx; }
+    double cellWidthX(int i) const { return 1.0 / mesh_x.invCellWidth()[i]; }
+    double cellWidthY(int j) const { return 1.0 / mesh_y.invCellWidth()[j]; }
+    double timeStep() const { return dt; }
+    void gatherMesh(YeeField f, const std::vector<size_t> &nodes, float *out) const;
+
+    // Strength-weighted magnet vector field (Bx, By) on the display grid, kept next to the scalar
+    // field for flux-line plots. Only in-memory static fields without symmetry reduction or mesh
+    // refinement have one; enabling it recomputes the static field on the next step().
+    void keepVectorField(bool on);
+    bool hasVectorField() const { return !Bx.empty(); }
+    const std::vector<float>& fieldBx() const { return Bx; }
+    const std::vector<float>& fieldBy() const { return By; }
 
 private:
-    int nx, ny;
+    enum class Boundary { None, PEC, PMC, Periodic };
+    struct FieldWindow { int i0, j0, i1, j1; };  // Mesh nodes [i0,i1) x [j0,j1)
+
+    // Interpolation stencil from each full display column/row onto the mesh
+    struct DisplayMap {
+        std::vector<int> k0, k1;
+        std::vector<float> t;
+        std::vector<float> sign;  // -1 across PEC planes (odd Ez)
+    };
+
+    int nx, ny;               // Computed mesh nodes
+    int full_nx, full_ny;     // Display extent before symmetry reduction
+    int cells_x, cells_y;     // Display cells of the irreducible block
+    MeshAxis mesh_x, mesh_y;
     double dx, dy;
     double dt;
 
@@ -69,10 +154,48 @@ private:
     std::vector<float> Hx;
     std::vector<float> Hy;
     std::vector<float> eps_r;
+    std::vector<float> cez;   // c0*dt/eps_r update coefficient per cell
+    std::vector<float> ch_hy; // c0*dt/spacing per column (Hy update)
+    std::vector<float> ch_hx; // c0*dt/spacing per row (Hx update)
+    std::vector<float> Bx, By;  // Static vector field (SoA), empty unless keep_vector
+    bool keep_vector = false;
+
+    CPML cpml;                // Absorbing boundary strips (disabled when pml_cells == 0)
+    QuadtreeField quadtree;   // Replaces the uniform static field when grid.adaptive is enabled
+    bool out_of_core = false;
+    OutOfCoreConfig ooc_conf;
+    TiledField tiled_ez, tiled_hx, tiled_hy;  // Memory-mapped fields replacing Ez/Hx/Hy out-of-core
+    int display_w = 0, display_h = 0;         // Size of the field returned by getEz()
+    std::unique_ptr<DomainDecomposition> decomposition;  // Worker processes own the grid (grid.decomposition)
+    std::vector<int> rows;    // Row indices driving the parallel kernels
+    std::unique_ptr<YeeCore> core;  // In-memory Yee update at the grid.solver precision and kernel
+    ProbeSet *probes = nullptr;
+    SolverPrecision precision = SolverPrecision::Float;
+    SolverKernel kernel_policy = SolverKernel::Threaded;
+    int nstep = 0;
+    bool static_field_ready = false;
+    std::vector<FieldWindow> dirty_windows;  // Pending local static-field updates
+    double window_error = 0.0;               // Bound on the error the windows left outside them
+
+    Boundary sym_x = Boundary::None, sym_y = Boundary::None;
+    int ez_i0 = 1, ez_i1 = 0, ez_j0 = 1, ez_j1 = 0;  // Updated Ez range [i0,i1) x [j0,j1)
+    DisplayMap col_map, row_map;
+    unsigned long long field_version = 0;
+    mutable unsigned long long expanded_version = ~0ull;
+    mutable std::vector<float> Ez_full;
 
     std::vector<Source> sources;
+    std::vector<int> source_nodes;  // Mesh cell driven by each source (-1 = outside)
     std::vector<MagnetConfig> magnet_configs; // New: store magnet configurations
 
+    void updateTiledH();
+    void updateTiledE();
+    const std::vector<float>& meshEz() const;  // Solver-mesh Ez as fp32 at any precision
+    template <typename Real> void computeStaticField(const std::vector<MagnetConfig> &field_magnets, const FieldWindow &window);
+    bool queueMagnetWindow(const MagnetConfig &magnet);
+    std::vector<MagnetConfig> symmetryMagnets() const;
+    static Boundary parseBoundary(const std::string &name, int period, int n);
     void applySources(int nstep);
+    uint64_t stateFingerprint() const;
     inline int idx(int i, int j) const { return j*nx + i; }
 };
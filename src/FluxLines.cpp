@@ -0,0 +1,153 @@
+#include "FluxLines.hpp"
+#include "FDTD.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <execution>
+#include <iostream>
+#include <numeric>
+
+namespace {
+
+// Bilinear (Bx, By) at display position (x, y); false outside the grid
+struct FieldSampler {
+    const float *bx, *by;
+    int w, h;
+
+    bool contains(float x, float y) const { return x >= 0.0f && y >= 0.0f && x <= w - 1 && y <= h - 1; }
+
+    bool operator()(float x, float y, float &vx, float &vy) const {
+        if (!contains(x, y)) return false;
+        const int i = std::min(static_cast<int>(x), w - 2);
+        const int j = std::min(static_cast<int>(y), h - 2);
+        const float tx = x - i, ty = y - j;
+        const size_t k = static_cast<size_t>(j) * w + i;
+        auto lerp = [&](const float *f) {
+            const float top = f[k] + tx * (f[k + 1] - f[k]);
+            const float bottom = f[k + w] + tx * (f[k + w + 1] - f[k + w]);
+            return top + ty * (bottom - top);
+        };
+        vx = lerp(bx);
+        vy = lerp(by);
+        return true;
+    }
+};
+
+// Integrates one direction from (x0, y0), writing up to `limit` vertices after the seed
+int traceDirection(const FieldSampler &B, float x0, float y0, float sign, const FluxLineConfig &conf,
+                   float *xs, float *ys, int limit) {
+    const float tol = static_cast<float>(conf.tolerance);
+    const float h_max = static_cast<float>(conf.max_step);
+    const float h_min = std::min(0.05f, h_max);
+    // Unit direction along +-B; false outside the grid or where the field vanishes
+    auto dir = [&](float x, float y, float &dx, float &dy) {
+        float vx, vy;
+        if (!B(x, y, vx, vy)) return false;
+        const float mag = std::sqrt(vx * vx + vy * vy);
+        if (!(mag > 1e-12f)) return false;
+        dx = sign * vx / mag;
+        dy = sign * vy / mag;
+        return true;
+    };
+
+    float x = x0, y = y0, h = std::min(1.0f, h_max), length = 0.0f;
+    float k1x, k1y;
+    if (!dir(x, y, k1x, k1y)) return 0;
+    int n = 0;
+    for (int attempts = 0; n < limit && attempts < 4 * limit; ++attempts) {
+        float k2x, k2y, k3x, k3y, k4x, k4y;
+        if (!dir(x + 0.5f * h * k1x, y + 0.5f * h * k1y, k2x, k2y)) break;
+        if (!dir(x + 0.75f * h * k2x, y + 0.75f * h * k2y, k3x, k3y)) break;
+        const float nx = x + h * (2.0f / 9.0f * k1x + 1.0f / 3.0f * k2x + 4.0f / 9.0f * k3x);
+        const float ny = y + h * (2.0f / 9.0f * k1y + 1.0f / 3.0f * k2y + 4.0f / 9.0f * k3y);
+        const bool inside = dir(nx, ny, k4x, k4y);
+
+        // Embedded second-order solution gives the local error; the last stage is reused (FSAL)
+        float err = tol;
+        if (inside) {
+            const float ex = h * (-5.0f / 72.0f * k1x + 1.0f / 12.0f * k2x + 1.0f / 9.0f * k3x - 1.0f / 8.0f * k4x);
+            const float ey = h * (-5.0f / 72.0f * k1y + 1.0f / 12.0f * k2y + 1.0f / 9.0f * k3y - 1.0f / 8.0f * k4y);
+            err = std::sqrt(ex * ex + ey * ey);
+        }
+        if (inside && err > tol && h > h_min) {
+            h = std::max(h_min, h * std::max(0.2f, 0.9f * std::cbrt(tol / err)));
+            continue;
+        }
+        if (!inside && !B.contains(nx, ny)) break;  // Left the domain
+        xs[n] = nx;
+        ys[n] = ny;
+        ++n;
+        // Outside, or folding back on itself: the line ran into a magnet core (a sink of the direction field)
+        if (!inside || k1x * k4x + k1y * k4y < 0.0f) break;
+        length += h;
+        x = nx; y = ny;
+        k1x = k4x; k1y = k4y;
+        // Closed loop back onto the seed
+        if (length > 4.0f * h_max && (x - x0) * (x - x0) + (y - y0) * (y - y0) < 0.25f * h * h) break;
+        h = std::min(h_max, std::max(h_min, h * std::min(5.0f, 0.9f * std::cbrt(tol / std::max(err, 1e-9f)))));
+    }
+    return n;
+}
+
+}
+
+FluxLines::FluxLines(const FluxLineConfig &conf_) {
+    reconfigure(conf_);
+}
+
+void FluxLines::reconfigure(const FluxLineConfig &conf_) {
+    conf = conf_;
+    conf.seeds = std::max(conf.seeds, 1);
+    conf.max_points = std::max(conf.max_points, 3);
+    conf.tolerance = std::max(conf.tolerance, 1e-4);
+    conf.max_step = std::max(conf.max_step, 0.1);
+    stride = static_cast<size_t>(conf.max_points);
+    field_version = ~0ull;  // Versions of a different solver instance are not comparable
+}
+
+bool FluxLines::update(const FDTD &sim) {
+    if (!sim.hasVectorField() || sim.meshWidth() < 2 || sim.meshHeight() < 2) {
+        counts.clear();
+        total_points = 0;
+        field_version = ~0ull;
+        return false;
+    }
+    if (sim.fieldVersion() == field_version) return false;
+    field_version = sim.fieldVersion();
+
+    auto start = std::chrono::high_resolution_clock::now();
+    const int w = sim.meshWidth(), h = sim.meshHeight();
+    const FieldSampler B{sim.fieldBx().data(), sim.fieldBy().data(), w, h};
+
+    // Regular seed grid with the domain's aspect ratio
+    const int gx = std::max(1, static_cast<int>(std::lround(std::sqrt(conf.seeds * static_cast<double>(w) / h))));
+    const int gy = std::max(1, conf.seeds / gx);
+    const size_t lines = static_cast<size_t>(gx) * gy;
+    px.resize(lines * stride);
+    py.resize(lines * stride);
+    counts.assign(lines, 0);
+
+    std::vector<int> seeds(lines);
+    std::iota(seeds.begin(), seeds.end(), 0);
+    const int half = (conf.max_points - 1) / 2;
+    std::for_each(std::execution::par, seeds.begin(), seeds.end(), [&](int s) {
+        const float sx = (s % gx + 0.5f) * (w - 1) / gx;
+        const float sy = (s / gx + 0.5f) * (h - 1) / gy;
+        float *lx = &px[s * stride], *ly = &py[s * stride];
+        // Backward half first, reversed in place so the polyline runs along +B through the seed
+        const int back = traceDirection(B, sx, sy, -1.0f, conf, lx, ly, half);
+        std::reverse(lx, lx + back);
+        std::reverse(ly, ly + back);
+        lx[back] = sx;
+        ly[back] = sy;
+        const int fwd = traceDirection(B, sx, sy, 1.0f, conf, lx + back + 1, ly + back + 1,
+                                       conf.max_points - back - 1);
+        counts[s] = back + 1 + fwd;
+    });
+    total_points = std::accumulate(counts.begin(), counts.end(), size_t(0));
+    ++traced;
+    trace_s = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+    std::cout << "Traced " << lines << " flux lines (" << total_points << " vertices) in "
+              << 1000.0 * trace_s << "ms" << std::endl;
+    return true;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include "Config.hpp"
+
+class FDTD;
+
+// Flux-line (streamline) tracer over the kept Bx/By vector field of a static scene
+// Every seed of a regular grid is integrated forwards and backwards along B/|B| with an
+// adaptive Bogacki-Shampine RK3(2) step and bilinear sampling, in parallel across seeds.
+// Lines are cached as polylines in display-cell coordinates and retraced only when the
+// solver's field version changes; lines end at the domain edge, in field-free magnet
+// cores, when they close on their seed or after max_points vertices.
+class FluxLines {
+public:
+    explicit FluxLines(const FluxLineConfig &conf);
+    // New settings or a rebuilt solver: the next update() retraces
+    void reconfigure(const FluxLineConfig &conf);
+
+    // Retraces if the field changed since the last call; true when the lines are new
+    bool update(const FDTD &sim);
+
+    size_t lineCount() const { return counts.size(); }
+    int pointCount(size_t line) const { return counts[line]; }
+    const float* xs(size_t line) const { return &px[line * stride]; }
+    const float* ys(size_t line) const { return &py[line * stride]; }
+    size_t totalPoints() const { return total_points; }
+    unsigned long long version() const { return traced; }  // Bumped on every retrace
+    double lastTraceSeconds() const { return trace_s; }
+
+private:
+    FluxLineConfig conf;
+    size_t stride = 0;                  // max_points slots per line
+    std::vector<float> px, py;          // lineCount() x stride vertices
+    std::vector<int> counts;
+    size_t total_points = 0;
+    unsigned long long field_version = ~0ull;
+    unsigned long long traced = 0;
+    double trace_s = 0.0;
+};
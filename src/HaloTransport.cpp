@@ -0,0 +1,67 @@
+#include "HaloTransport.hpp"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <thread>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#endif
+
+ShmRingTransport::ShmRingTransport(int ranks_, size_t max_count_, int slots_)
+: ranks(ranks_), slots(std::max(slots_, 2)), max_count(max_count_) {
+    channel_bytes = sizeof(Channel) + static_cast<size_t>(slots) * max_count * sizeof(float);
+    channel_bytes = (channel_bytes + 63) & ~static_cast<size_t>(63);
+    mapped_bytes = channel_bytes * 2 * ranks;
+#ifdef _WIN32
+    std::cerr << "Shared-memory halo transport needs POSIX shared mappings\n";
+#else
+    void *p = mmap(nullptr, mapped_bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) {
+        std::cerr << "Could not map " << (mapped_bytes >> 10) << " KB of shared memory for halo rings\n";
+        return;
+    }
+    base = static_cast<char*>(p);
+    for (int k = 0; k < 2 * ranks; ++k) {
+        Channel *c = new (base + k * channel_bytes) Channel;
+        c->head.store(0, std::memory_order_relaxed);
+        c->tail.store(0, std::memory_order_relaxed);
+    }
+#endif
+}
+
+ShmRingTransport::~ShmRingTransport() {
+#ifndef _WIN32
+    if (base) munmap(base, mapped_bytes);
+#endif
+}
+
+ShmRingTransport::Channel* ShmRingTransport::channel(int from, int to) const {
+    const int direction = to > from ? 1 : 0;
+    return reinterpret_cast<Channel*>(base + (2 * from + direction) * channel_bytes);
+}
+
+float* ShmRingTransport::slot(Channel *c, uint64_t n) const {
+    return reinterpret_cast<float*>(reinterpret_cast<char*>(c) + sizeof(Channel)) + (n % slots) * max_count;
+}
+
+void ShmRingTransport::send(int peer, const float *data, size_t count) {
+    Channel *c = channel(rank, peer);
+    const uint64_t head = c->head.load(std::memory_order_relaxed);
+    while (head - c->tail.load(std::memory_order_acquire) >= static_cast<uint64_t>(slots)) {
+        std::this_thread::yield(); // Ring full: the peer is more than `slots` messages behind
+    }
+    std::memcpy(slot(c, head), data, std::min(count, max_count) * sizeof(float));
+    c->head.store(head + 1, std::memory_order_release);
+}
+
+void ShmRingTransport::recv(int peer, float *data, size_t count) {
+    Channel *c = channel(peer, rank);
+    const uint64_t tail = c->tail.load(std::memory_order_relaxed);
+    while (c->head.load(std::memory_order_acquire) == tail) {
+        std::this_thread::yield();
+    }
+    std::memcpy(data, slot(c, tail), std::min(count, max_count) * sizeof(float));
+    c->tail.store(tail + 1, std::memory_order_release);
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Point-to-point halo exchange between the ranks of a decomposed run
+// A transport is created in the parent before the workers start; each worker then
+// calls attach() with its rank. send() returns as soon as the data is queued so the
+// caller can overlap interior work with the transfer; recv() blocks until the peer's
+// next message arrives. Messages between a pair of ranks are delivered in order.
+class HaloTransport {
+public:
+    virtual ~HaloTransport() = default;
+    virtual const char* name() const = 0;
+    virtual void attach(int rank) = 0;
+    virtual void send(int peer, const float *data, size_t count) = 0;
+    virtual void recv(int peer, float *data, size_t count) = 0;
+};
+
+// Same-host transport: one single-producer/single-consumer ring per ordered pair of
+// neighbouring ranks, in an anonymous shared mapping inherited by forked workers
+class ShmRingTransport : public HaloTransport {
+public:
+    // max_count: largest message in floats; slots: messages in flight per direction
+    ShmRingTransport(int ranks, size_t max_count, int slots = 4);
+    ~ShmRingTransport() override;
+
+    bool valid() const { return base != nullptr; }
+    const char* name() const override { return "shm"; }
+    void attach(int rank_) override { rank = rank_; }
+    void send(int peer, const float *data, size_t count) override;
+    void recv(int peer, float *data, size_t count) override;
+
+private:
+    struct alignas(64) Channel {
+        std::atomic<uint64_t> head;   // Messages written by the producer
+        char pad[64 - sizeof(std::atomic<uint64_t>)];
+        std::atomic<uint64_t> tail;   // Messages consumed
+    };
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "shared-memory rings need lock-free atomics");
+
+    int ranks = 0;
+    int rank = 0;
+    int slots = 0;
+    size_t max_count = 0;
+    size_t channel_bytes = 0;
+    size_t mapped_bytes = 0;
+    char *base = nullptr;
+
+    // Rings exist for rank r -> r-1 (direction 0) and r -> r+1 (direction 1)
+    Channel* channel(int from, int to) const;
+    float* slot(Channel *c, uint64_t n) const;
+};
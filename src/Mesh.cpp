@@ -0,0 +1,102 @@
+#include "Mesh.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace {
+struct Span { double a, b, cell; };
+}
+
+MeshAxis::MeshAxis(int cells, double cell_size, const MeshConfig &mesh, bool along_x,
+                   bool mirror, bool periodic)
+: wraps(periodic) {
+    span = periodic ? cells : cells - 1;
+
+    // Project refinement boxes onto this axis, folding them into the computed extent
+    std::vector<Span> spans;
+    for (const auto &box : mesh.refine) {
+        const double a = along_x ? box.x0 : box.y0;
+        const double b = a + (along_x ? box.w : box.h);
+        const double cell = std::max(box.cell, 0.05);
+        if (periodic) {
+            for (double shift = -std::floor(b / span) * span; a + shift < span; shift += span) {
+                spans.push_back({a + shift, b + shift, cell});
+            }
+        } else {
+            spans.push_back({a, b, cell});
+            if (mirror) spans.push_back({2.0 * span - b, 2.0 * span - a, cell});
+        }
+    }
+
+    const double max_cell = std::max(mesh.max_cell, 0.05);
+    uniform = spans.empty() && max_cell == 1.0;
+
+    if (uniform) {
+        for (int k = 0; k < cells; ++k) nodes.push_back(k);
+    } else {
+        // Target spacing grows linearly with distance from each box, which is the
+        // continuous form of a geometric grading with ratio `grading`
+        const double growth = std::max(mesh.grading, 1.0) - 1.0;
+        auto target = [&](double x) {
+            double h = max_cell;
+            for (const auto &s : spans) {
+                const double dist = x < s.a ? s.a - x : (x > s.b ? x - s.b : 0.0);
+                h = std::min(h, s.cell + growth * dist);
+            }
+            return h;
+        };
+
+        double p = 0.0;
+        nodes.push_back(p);
+        while (true) {
+            const double h = target(p + 0.5 * target(p));
+            if (p + h >= span - 0.5 * h) break; // Remaining gap closes the axis
+            p += h;
+            nodes.push_back(p);
+        }
+        if (!periodic) nodes.push_back(span); // Walls and mirror planes sit on a node
+    }
+
+    // Physical node spacing (H positions) and dual-cell widths (E positions)
+    const int n = size();
+    std::vector<double> dn(n);
+    for (int k = 0; k + 1 < n; ++k) dn[k] = (nodes[k+1] - nodes[k]) * cell_size;
+    dn[n-1] = periodic ? (span - nodes[n-1]) * cell_size : dn[std::max(n-2, 0)];
+
+    inv_dn.resize(n);
+    inv_dc.resize(n);
+    min_spacing = dn[0];
+    for (int k = 0; k < n; ++k) {
+        const double before = k > 0 ? dn[k-1] : (periodic ? dn[n-1] : dn[0]);
+        inv_dn[k] = static_cast<float>(1.0 / dn[k]);
+        inv_dc[k] = static_cast<float>(2.0 / (before + dn[k]));
+        min_spacing = std::min(min_spacing, dn[k]);
+    }
+
+    if (!uniform) {
+        std::cout << "Graded mesh (" << (along_x ? "x" : "y") << "): " << n << " nodes for " << cells
+                  << " display cells, spacing " << (min_spacing / cell_size) << "-" << max_cell << " cells" << std::endl;
+    }
+}
+
+void MeshAxis::locate(double x, int &k0, int &k1, float &t) const {
+    const int n = size();
+    auto it = std::upper_bound(nodes.begin(), nodes.end(), x);
+    k0 = std::max(static_cast<int>(it - nodes.begin()) - 1, 0);
+    if (k0 >= n - 1) {
+        k0 = n - 1;
+        k1 = wraps ? 0 : k0;
+        t = wraps ? static_cast<float>((x - nodes[k0]) / (span - nodes[k0])) : 0.0f;
+    } else {
+        k1 = k0 + 1;
+        t = static_cast<float>((x - nodes[k0]) / (nodes[k1] - nodes[k0]));
+    }
+    t = std::clamp(t, 0.0f, 1.0f);
+}
+
+int MeshAxis::nearest(double x) const {
+    int k0, k1;
+    float t;
+    locate(x, k0, k1, t);
+    return t < 0.5f ? k0 : k1;
+}
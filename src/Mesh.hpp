@@ -0,0 +1,38 @@
+#pragma once
+
+#include <vector>
+#include "Config.hpp"
+
+// Graded non-uniform mesh along one axis
+// Node positions are in display-grid cells so magnets, materials and sources keep
+// their integer display coordinates; the solver reads the physical spacing arrays.
+// Without refinement (max_cell == 1, no boxes) nodes sit exactly on 0, 1, ..., n-1.
+class MeshAxis {
+public:
+    MeshAxis() = default;
+    // cells: display cells of the computed (possibly symmetry-reduced) extent
+    // mirror: last node is a mirror plane; periodic: the axis wraps after `cells`
+    MeshAxis(int cells, double cell_size, const MeshConfig &mesh, bool along_x,
+             bool mirror, bool periodic);
+
+    int size() const { return static_cast<int>(nodes.size()); }
+    bool isUniform() const { return uniform; }
+    double position(int k) const { return nodes[k]; }
+    double minSpacing() const { return min_spacing; }
+
+    // Physical 1/spacing between node k and k+1 (wraps on periodic axes) and 1/dual-cell width at node k
+    const std::vector<float>& invNodeSpacing() const { return inv_dn; }
+    const std::vector<float>& invCellWidth() const { return inv_dc; }
+
+    // Linear interpolation stencil for a display coordinate: value = (1-t)*f[k0] + t*f[k1]
+    void locate(double x, int &k0, int &k1, float &t) const;
+    int nearest(double x) const;
+
+private:
+    std::vector<double> nodes;
+    std::vector<float> inv_dn, inv_dc;
+    double span = 0.0;
+    double min_spacing = 0.0;
+    bool uniform = true;
+    bool wraps = false;
+};
@@ -0,0 +1,220 @@
+#include "PinnedPool.hpp"
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+thread_local const PinnedPool* PinnedPool::worker_pool = nullptr;
+
+namespace {
+
+// "0-3,8-11" -> {0, 1, 2, 3, 8, 9, 10, 11}
+std::vector<int> parseCpuList(const std::string &list) {
+    std::vector<int> out;
+    std::stringstream ss(list);
+    std::string range;
+    while (std::getline(ss, range, ',')) {
+        if (range.empty()) continue;
+        const size_t dash = range.find('-');
+        const int lo = std::atoi(range.c_str());
+        const int hi = dash == std::string::npos ? lo : std::atoi(range.c_str() + dash + 1);
+        for (int c = lo; c <= hi; ++c) out.push_back(c);
+    }
+    return out;
+}
+
+std::string formatCpuList(const std::vector<int> &cpus) {
+    std::string out;
+    for (size_t k = 0; k < cpus.size();) {
+        size_t e = k;
+        while (e + 1 < cpus.size() && cpus[e + 1] == cpus[e] + 1) ++e;
+        if (!out.empty()) out += ",";
+        out += std::to_string(cpus[k]) + (e > k ? "-" + std::to_string(cpus[e]) : "");
+        k = e + 1;
+    }
+    return out;
+}
+
+std::mutex shared_m;
+std::unique_ptr<PinnedPool> shared_pool;
+
+}
+
+NumaTopology NumaTopology::detect() {
+    NumaTopology topo;
+#if defined(__linux__)
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    const bool have_mask = sched_getaffinity(0, sizeof(allowed), &allowed) == 0;
+    std::vector<int> node_ids;
+    std::error_code ec;
+    for (const auto &entry : std::filesystem::directory_iterator("/sys/devices/system/node", ec)) {
+        const std::string name = entry.path().filename().string();
+        if (name.size() > 4 && name.compare(0, 4, "node") == 0 && std::isdigit(static_cast<unsigned char>(name[4]))) {
+            node_ids.push_back(std::atoi(name.c_str() + 4));
+        }
+    }
+    std::sort(node_ids.begin(), node_ids.end());
+    for (int node : node_ids) {
+        std::ifstream f("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+        std::string list;
+        std::getline(f, list);
+        std::vector<int> cpus;
+        for (int c : parseCpuList(list)) {
+            if (!have_mask || (c < CPU_SETSIZE && CPU_ISSET(c, &allowed))) cpus.push_back(c);
+        }
+        if (!cpus.empty()) topo.node_cpus.push_back(cpus);  // Memory-only and masked-out nodes are skipped
+    }
+    if (topo.node_cpus.empty() && have_mask) {
+        std::vector<int> cpus;
+        for (int c = 0; c < CPU_SETSIZE; ++c) if (CPU_ISSET(c, &allowed)) cpus.push_back(c);
+        if (!cpus.empty()) topo.node_cpus.push_back(cpus);
+    }
+#endif
+    if (topo.node_cpus.empty()) {
+        std::vector<int> cpus(std::max(1u, std::thread::hardware_concurrency()));
+        for (size_t c = 0; c < cpus.size(); ++c) cpus[c] = static_cast<int>(c);
+        topo.node_cpus.push_back(cpus);
+    }
+    return topo;
+}
+
+int NumaTopology::cpus() const {
+    int n = 0;
+    for (const auto &c : node_cpus) n += static_cast<int>(c.size());
+    return n;
+}
+
+std::string NumaTopology::describe() const {
+    std::string out = std::to_string(nodes()) + (nodes() == 1 ? " node (" : " nodes (");
+    for (size_t k = 0; k < node_cpus.size(); ++k) out += (k ? " | " : "") + formatCpuList(node_cpus[k]);
+    return out + ")";
+}
+
+PinnedPool::PinnedPool(const PinnedPoolOptions &options) : opts(options) {
+    const NumaTopology topo = NumaTopology::detect();
+    nodes_used = opts.nodes > 0 ? std::min(opts.nodes, topo.nodes()) : topo.nodes();
+    int available = 0;
+    for (int n = 0; n < nodes_used; ++n) available += static_cast<int>(topo.node_cpus[n].size());
+    const int threads = opts.threads > 0 ? opts.threads : available;
+
+    // Workers are split across the used nodes in proportion to their CPUs and numbered node by
+    // node, so consecutive row blocks (and their pages) share a socket. More threads than CPUs
+    // wrap around onto the same cores.
+    for (int n = 0, given = 0; n < nodes_used; ++n) {
+        const auto &node = topo.node_cpus[n];
+        const int quota = n + 1 == nodes_used ? threads - given
+                        : static_cast<int>(static_cast<int64_t>(threads) * node.size() / available);
+        for (int k = 0; k < quota; ++k) {
+            cpus.push_back(node[k % node.size()]);
+            worker_nodes.push_back(n);
+        }
+        given += quota;
+    }
+    for (int k = 0; k < size(); ++k) workers.emplace_back([this, k] { workerLoop(k); });
+}
+
+PinnedPool::~PinnedPool() {
+    {
+        std::lock_guard<std::mutex> lock(m);
+        stopping = true;
+    }
+    start_cv.notify_all();
+    for (auto &t : workers) t.join();
+}
+
+PinnedPool& PinnedPool::shared() {
+    std::lock_guard<std::mutex> lock(shared_m);
+    if (!shared_pool) shared_pool = std::make_unique<PinnedPool>(PinnedPoolOptions{});
+    return *shared_pool;
+}
+
+void PinnedPool::configure(const PinnedPoolOptions &options) {
+    std::lock_guard<std::mutex> lock(shared_m);
+    if (shared_pool && shared_pool->options() == options) return;
+    // Let a region that is still running finish and keep new ones off the old workers until the
+    // replacement is in place; the lock is dropped before the old pool (which owns run_m) goes away
+    std::unique_ptr<PinnedPool> retired;
+    {
+        std::unique_lock<std::mutex> idle;
+        if (shared_pool) idle = std::unique_lock<std::mutex>(shared_pool->run_m);
+        retired = std::exchange(shared_pool, std::make_unique<PinnedPool>(options));
+    }
+    retired.reset();
+    const NumaTopology topo = NumaTopology::detect();
+    std::cout << "Pinned worker pool: " << shared_pool->size() << " threads on " << shared_pool->nodesUsed() << " of "
+              << topo.describe() << (options.huge_pages ? ", transparent huge pages requested" : "") << std::endl;
+}
+
+void PinnedPool::run(const std::function<void(int)> &f) {
+    std::unique_lock<std::mutex> region(run_m, std::try_to_lock);
+    if (worker_pool == this || !region.owns_lock()) {
+        for (int w = 0; w < size(); ++w) f(w);
+        return;
+    }
+    std::unique_lock<std::mutex> lock(m);
+    job = &f;
+    remaining = size();
+    ++epoch;
+    start_cv.notify_all();
+    done_cv.wait(lock, [this] { return remaining == 0; });
+    job = nullptr;
+}
+
+void PinnedPool::releasePages(void *data, size_t bytes) const {
+#if defined(__linux__)
+    // Only whole pages inside the buffer; anonymous pages dropped with MADV_DONTNEED come back
+    // zero-filled on the next touch, which then allocates them on the toucher's node
+    const uintptr_t page = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+    const uintptr_t begin = (reinterpret_cast<uintptr_t>(data) + page - 1) & ~(page - 1);
+    const uintptr_t end = (reinterpret_cast<uintptr_t>(data) + bytes) & ~(page - 1);
+    if (end <= begin) return;
+#ifdef MADV_HUGEPAGE
+    if (opts.huge_pages) madvise(reinterpret_cast<void*>(begin), end - begin, MADV_HUGEPAGE);
+#endif
+    madvise(reinterpret_cast<void*>(begin), end - begin, MADV_DONTNEED);
+#else
+    (void)data;
+    (void)bytes;
+#endif
+}
+
+void PinnedPool::workerLoop(int self) {
+    worker_pool = this;
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpus[self], &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#elif defined(_WIN32)
+    if (cpus[self] < 64) SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << cpus[self]);
+#endif
+    uint64_t seen = 0;
+    while (true) {
+        const std::function<void(int)> *f;
+        {
+            std::unique_lock<std::mutex> lock(m);
+            start_cv.wait(lock, [&] { return stopping || epoch != seen; });
+            if (stopping) return;
+            seen = epoch;
+            f = job;
+        }
+        (*f)(self);
+        std::lock_guard<std::mutex> lock(m);
+        if (--remaining == 0) done_cv.notify_all();
+    }
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// CPUs this process may run on, grouped by NUMA node (Linux sysfs; a single node elsewhere)
+struct NumaTopology {
+    std::vector<std::vector<int>> node_cpus;
+
+    static NumaTopology detect();
+    int nodes() const { return static_cast<int>(node_cpus.size()); }
+    int cpus() const;
+    std::string describe() const;  // e.g. "2 nodes (0-15 | 16-31)"
+};
+
+struct PinnedPoolOptions {
+    int threads = 0;          // 0 = every allowed CPU of the used nodes
+    int nodes = 0;            // 0 = all nodes, otherwise the first `nodes` of them
+    bool huge_pages = true;   // MADV_HUGEPAGE on placed buffers (Linux THP)
+
+    bool operator==(const PinnedPoolOptions &o) const {
+        return threads == o.threads && nodes == o.nodes && huge_pages == o.huge_pages;
+    }
+};
+
+// Fork-join pool for the "pinned" solver kernel. Workers are pinned to one CPU each, node by
+// node, and worker w always owns the same contiguous block of rows. Buffers placed with
+// firstTouch() are faulted in by their owners, so every row block lives on the socket whose
+// cores update it, instead of on the node of whichever thread happened to zero the buffer.
+class PinnedPool {
+public:
+    explicit PinnedPool(const PinnedPoolOptions &options);
+    ~PinnedPool();
+    PinnedPool(const PinnedPool&) = delete;
+    PinnedPool& operator=(const PinnedPool&) = delete;
+
+    // Process-wide pool of the pinned kernel; configure() rebuilds it when the options change
+    static PinnedPool& shared();
+    static void configure(const PinnedPoolOptions &options);
+
+    int size() const { return static_cast<int>(cpus.size()); }
+    int nodesUsed() const { return nodes_used; }
+    int workerNode(int w) const { return worker_nodes[w]; }
+    bool hugePages() const { return opts.huge_pages; }
+    const PinnedPoolOptions& options() const { return opts; }
+
+    // Rows [0, n) in size() contiguous blocks; worker w owns [b0, b1)
+    void rowBlock(int w, int n, int &b0, int &b1) const {
+        b0 = static_cast<int>(static_cast<int64_t>(n) * w / size());
+        b1 = static_cast<int>(static_cast<int64_t>(n) * (w + 1) / size());
+    }
+
+    // job(worker) on every worker; returns when all have finished. Calls from a worker, or
+    // while another thread is inside run(), execute inline on the caller.
+    void run(const std::function<void(int)> &job);
+
+    // f(j) for j in [j0, j1), each row on the worker owning it within [0, n)
+    template <typename F> void forRows(int n, int j0, int j1, F &&f) {
+        run([&](int w) {
+            int b0, b1;
+            rowBlock(w, n, b0, b1);
+            for (int j = std::max(b0, j0); j < std::min(b1, j1); ++j) f(j);
+        });
+    }
+
+    // Releases the pages of `rows` x `row` elements and lets every worker re-fault its own rows
+    // filled with `value`. Without the release the pages stay where they were first touched.
+    template <typename T> void firstTouch(T *data, int rows, size_t row, T value) {
+        if (!data || rows <= 0) return;
+        releasePages(data, static_cast<size_t>(rows) * row * sizeof(T));
+        forRows(rows, 0, rows, [&](int j) { std::fill(data + j * row, data + (j + 1) * row, value); });
+    }
+    template <typename T> void firstTouch(std::vector<T> &v, int rows, T value) {
+        if (!v.empty()) firstTouch(v.data(), rows, v.size() / rows, value);
+    }
+
+private:
+    PinnedPoolOptions opts;
+    std::vector<int> cpus;           // CPU of each worker
+    std::vector<int> worker_nodes;   // NUMA node of each worker
+    int nodes_used = 1;
+    std::vector<std::thread> workers;
+
+    std::mutex run_m;                // One fork-join region at a time
+    std::mutex m;
+    std::condition_variable start_cv, done_cv;
+    const std::function<void(int)> *job = nullptr;
+    uint64_t epoch = 0;
+    int remaining = 0;
+    bool stopping = false;
+
+    static thread_local const PinnedPool* worker_pool;
+
+    void releasePages(void *data, size_t bytes) const;
+    void workerLoop(int self);
+};
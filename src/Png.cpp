@@ -0,0 +1,177 @@
+#include "Png.hpp"
+#include "Checkpoint.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+
+namespace {
+const unsigned short length_base[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                        35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+const unsigned char length_extra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                        3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+const unsigned short dist_base[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+                                      257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+const unsigned char dist_extra[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+                                      7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+// Deflate bit stream: values LSB first, Huffman codes MSB first
+class BitWriter {
+public:
+    explicit BitWriter(std::vector<unsigned char> &out_) : out(out_) {}
+    void bits(uint32_t value, int n) {
+        acc |= static_cast<uint64_t>(value) << count;
+        count += n;
+        while (count >= 8) {
+            out.push_back(static_cast<unsigned char>(acc));
+            acc >>= 8;
+            count -= 8;
+        }
+    }
+    void huffman(uint32_t code, int n) {
+        uint32_t reversed = 0;
+        for (int k = 0; k < n; ++k) reversed |= ((code >> k) & 1u) << (n - 1 - k);
+        bits(reversed, n);
+    }
+    void flush() {
+        if (count > 0) out.push_back(static_cast<unsigned char>(acc));
+        acc = 0;
+        count = 0;
+    }
+
+private:
+    std::vector<unsigned char> &out;
+    uint64_t acc = 0;
+    int count = 0;
+};
+
+void putSymbol(BitWriter &bw, int sym) {
+    if (sym <= 143) bw.huffman(0x30 + sym, 8);
+    else if (sym <= 255) bw.huffman(0x190 + sym - 144, 9);
+    else if (sym <= 279) bw.huffman(sym - 256, 7);
+    else bw.huffman(0xC0 + sym - 280, 8);
+}
+
+void putMatch(BitWriter &bw, int length, int distance) {
+    const int lc = static_cast<int>(std::upper_bound(length_base, length_base + 29, length) - length_base) - 1;
+    putSymbol(bw, 257 + lc);
+    bw.bits(length - length_base[lc], length_extra[lc]);
+    const int dc = static_cast<int>(std::upper_bound(dist_base, dist_base + 30, distance) - dist_base) - 1;
+    bw.huffman(dc, 5);
+    bw.bits(distance - dist_base[dc], dist_extra[dc]);
+}
+
+uint32_t adler32(const std::vector<unsigned char> &data) {
+    uint32_t a = 1, b = 0;
+    size_t k = 0;
+    while (k < data.size()) {
+        const size_t end = std::min(data.size(), k + 5552);  // Largest block without uint32 overflow
+        for (; k < end; ++k) {
+            a += data[k];
+            b += a;
+        }
+        a %= 65521;
+        b %= 65521;
+    }
+    return (b << 16) | a;
+}
+
+void zlibCompress(const std::vector<unsigned char> &raw, size_t stride, bool compress, std::vector<unsigned char> &z) {
+    z.push_back(0x78);
+    z.push_back(0x01);
+    if (!compress) {
+        for (size_t k = 0; k < raw.size() || k == 0; k += 65535) {
+            const size_t len = std::min<size_t>(65535, raw.size() - k);
+            z.push_back(k + len >= raw.size() ? 1 : 0);
+            z.push_back(static_cast<unsigned char>(len));
+            z.push_back(static_cast<unsigned char>(len >> 8));
+            z.push_back(static_cast<unsigned char>(~len));
+            z.push_back(static_cast<unsigned char>(~len >> 8));
+            z.insert(z.end(), raw.begin() + k, raw.begin() + k + len);
+        }
+    } else {
+        BitWriter bw(z);
+        bw.bits(1, 1);  // BFINAL
+        bw.bits(1, 2);  // Fixed Huffman codes
+        const size_t n = raw.size();
+        const size_t distances[2] = {4, stride};
+        size_t i = 0;
+        while (i < n) {
+            size_t best_len = 0, best_dist = 0;
+            for (size_t d : distances) {
+                if (d > i || d > 32768) continue;
+                size_t len = 0;
+                const size_t max_len = std::min<size_t>(258, n - i);
+                while (len < max_len && raw[i + len] == raw[i + len - d]) ++len;
+                if (len > best_len) {
+                    best_len = len;
+                    best_dist = d;
+                }
+            }
+            if (best_len >= 3) {
+                putMatch(bw, static_cast<int>(best_len), static_cast<int>(best_dist));
+                i += best_len;
+            } else {
+                putSymbol(bw, raw[i++]);
+            }
+        }
+        putSymbol(bw, 256);
+        bw.flush();
+    }
+    const uint32_t adler = adler32(raw);
+    for (int shift = 24; shift >= 0; shift -= 8) z.push_back(static_cast<unsigned char>(adler >> shift));
+}
+
+void putChunk(std::vector<unsigned char> &out, const char *type, const std::vector<unsigned char> &data) {
+    const uint32_t len = static_cast<uint32_t>(data.size());
+    for (int shift = 24; shift >= 0; shift -= 8) out.push_back(static_cast<unsigned char>(len >> shift));
+    const size_t type_pos = out.size();
+    out.insert(out.end(), type, type + 4);
+    out.insert(out.end(), data.begin(), data.end());
+    const uint32_t crc = checkpoint::crc32(out.data() + type_pos, 4 + data.size());
+    for (int shift = 24; shift >= 0; shift -= 8) out.push_back(static_cast<unsigned char>(crc >> shift));
+}
+}
+
+namespace png {
+
+void encode(const unsigned char *rgba, int w, int h, bool compress, std::vector<unsigned char> &out) {
+    // Scanlines with filter type 0; the matcher's "pixel above" distance plays the role of the Up filter
+    const size_t row_bytes = static_cast<size_t>(w) * 4;
+    std::vector<unsigned char> raw;
+    raw.reserve((row_bytes + 1) * h);
+    for (int j = 0; j < h; ++j) {
+        raw.push_back(0);
+        raw.insert(raw.end(), rgba + j * row_bytes, rgba + (j + 1) * row_bytes);
+    }
+    std::vector<unsigned char> idat;
+    idat.reserve(compress ? raw.size() / 8 : raw.size() + raw.size() / 65535 * 5 + 16);
+    zlibCompress(raw, row_bytes + 1, compress, idat);
+
+    std::vector<unsigned char> ihdr;
+    for (uint32_t v : {static_cast<uint32_t>(w), static_cast<uint32_t>(h)}) {
+        for (int shift = 24; shift >= 0; shift -= 8) ihdr.push_back(static_cast<unsigned char>(v >> shift));
+    }
+    ihdr.insert(ihdr.end(), {8, 6, 0, 0, 0});  // 8-bit RGBA, deflate, no interlace
+
+    static const unsigned char signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+    out.assign(signature, signature + 8);
+    putChunk(out, "IHDR", ihdr);
+    putChunk(out, "IDAT", idat);
+    putChunk(out, "IEND", {});
+}
+
+bool write(const std::string &path, const unsigned char *rgba, int w, int h, bool compress, size_t *bytes) {
+    std::vector<unsigned char> data;
+    encode(rgba, w, h, compress, data);
+    std::ofstream ofs(path, std::ios::binary | std::ios::trunc);
+    ofs.write(reinterpret_cast<const char*>(data.data()), data.size());
+    if (!ofs) {
+        std::cerr << "Could not write PNG: " << path << "\n";
+        return false;
+    }
+    if (bytes) *bytes = data.size();
+    return true;
+}
+
+}
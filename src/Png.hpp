@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Minimal dependency-free PNG encoder for 8-bit RGBA images
+// Compression uses a single fixed-Huffman deflate block whose matcher only looks
+// at the previous pixel and the pixel above: colour-mapped fields consist of
+// large flat or slowly varying regions, so this gets most of zlib's ratio at a
+// fraction of the cost. Without compression the data goes into stored blocks.
+namespace png {
+
+void encode(const unsigned char *rgba, int w, int h, bool compress, std::vector<unsigned char> &out);
+bool write(const std::string &path, const unsigned char *rgba, int w, int h, bool compress, size_t *bytes = nullptr);
+
+}
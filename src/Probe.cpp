@@ -0,0 +1,287 @@
+#include "Probe.hpp"
+#include "FDTD.hpp"
+#include "YeeSolver.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+
+namespace {
+constexpr double eps0 = 8.8541878128e-12;  // F/m
+constexpr double eta0 = 376.730313668;     // Ohm; H is stored as eta0*H
+
+bool parseField(const std::string &name, YeeField &f) {
+    if (name == "ez") f = YeeField::Ez;
+    else if (name == "hx") f = YeeField::Hx;
+    else if (name == "hy") f = YeeField::Hy;
+    else return false;
+    return true;
+}
+}
+
+ProbeSet::ProbeSet(const ProbeSetConfig &conf_, const FDTD &sim) : conf(conf_) {
+    if (conf.list.empty()) return;
+    if (!sim.isTimeDomain() || sim.meshNode(0, 0) < 0) {
+        std::cout << "Probes need an in-memory time-domain run - " << conf.list.size() << " probes ignored" << std::endl;
+        return;
+    }
+    conf.interval = std::max(conf.interval, 1);
+    capacity = static_cast<size_t>(std::max(conf.buffer, 2));
+    batch = std::clamp(static_cast<size_t>(std::max(conf.batch, 1)), size_t(1), capacity);
+    dt = sim.timeStep();
+
+    std::error_code ec;
+    std::filesystem::create_directories(conf.dir, ec);
+    if (ec) {
+        std::cerr << "Could not create probe directory " << conf.dir << ": " << ec.message() << " - probes disabled\n";
+        return;
+    }
+    for (const auto &pc : conf.list) {
+        auto p = std::make_unique<Probe>();
+        p->conf = pc;
+        if (!build(*p, sim)) continue;
+        p->steps.assign(capacity, 0);
+        p->values.assign(capacity * p->width, 0.0f);
+        probes.push_back(std::move(p));
+    }
+    if (probes.empty()) return;
+
+    std::cout << "Recording " << probes.size() << " probes to " << conf.dir << "/ every " << conf.interval
+              << " steps (ring " << capacity << " samples, flushed every " << batch << ")" << std::endl;
+    writer = std::thread([this] { writerLoop(); });
+}
+
+ProbeSet::~ProbeSet() {
+    {
+        std::lock_guard<std::mutex> lock(m);
+        stopping = true;
+    }
+    wake_cv.notify_all();
+    if (writer.joinable()) writer.join();
+}
+
+bool ProbeSet::build(Probe &p, const FDTD &sim) {
+    const ProbeConfig &c = p.conf;
+    const std::string header = "step,t_s";
+    std::string columns;
+    if (c.type == "point" || c.type == "line") {
+        if (!parseField(c.quantity, p.field)) {
+            std::cout << "Probe '" << c.name << "': unknown quantity '" << c.quantity << "' - ignored" << std::endl;
+            return false;
+        }
+        // Display cells along the segment; consecutive cells sharing a mesh node are recorded once
+        const int ex = c.type == "line" ? c.x1 : c.x, ey = c.type == "line" ? c.y1 : c.y;
+        const int ddx = std::abs(ex - c.x), ddy = -std::abs(ey - c.y);
+        const int sx = c.x < ex ? 1 : -1, sy = c.y < ey ? 1 : -1;
+        int x = c.x, y = c.y, err = ddx + ddy;
+        while (true) {
+            const int node = sim.meshNode(x, y);
+            if (node >= 0 && (p.nodes.empty() || p.nodes.back() != static_cast<size_t>(node))) {
+                p.nodes.push_back(static_cast<size_t>(node));
+                columns += "," + c.quantity + (c.type == "line" ? "(" + std::to_string(sim.meshColumn(node)) + ":" +
+                                                  std::to_string(sim.meshRow(node)) + ")" : "");
+            }
+            if (x == ex && y == ey) break;
+            const int e2 = 2 * err;
+            if (e2 >= ddy) { err += ddy; x += sx; }
+            if (e2 <= ddx) { err += ddx; y += sy; }
+        }
+        if (p.nodes.empty()) {
+            std::cout << "Probe '" << c.name << "' lies outside the computed region - ignored" << std::endl;
+            return false;
+        }
+        p.kind = Kind::Field;
+        p.width = static_cast<int>(p.nodes.size());
+    } else if (c.type == "rect") {
+        if (c.quantity != "energy" && c.quantity != "flux") {
+            std::cout << "Probe '" << c.name << "': unknown quantity '" << c.quantity << "' - ignored" << std::endl;
+            return false;
+        }
+        const int n0 = sim.meshNode(c.x, c.y);
+        const int n1 = sim.meshNode(c.x + std::max(c.w, 0), c.y + std::max(c.h, 0));
+        if (n0 < 0 || n1 < 0) {
+            std::cout << "Probe '" << c.name << "': rectangle must lie inside the computed region - ignored" << std::endl;
+            return false;
+        }
+        const int i0 = sim.meshColumn(n0), j0 = sim.meshRow(n0);
+        const int i1 = sim.meshColumn(n1), j1 = sim.meshRow(n1);
+        const size_t w = static_cast<size_t>(sim.meshWidth());
+        auto node = [w](int i, int j) { return static_cast<size_t>(j) * w + i; };
+        if (c.quantity == "energy") {
+            p.kind = Kind::Energy;
+            for (int j = j0; j <= j1; ++j) {
+                for (int i = i0; i <= i1; ++i) {
+                    p.nodes.push_back(node(i, j));
+                    p.weights.push_back(static_cast<float>(sim.cellWidthX(i) * sim.cellWidthY(j)));
+                }
+            }
+            p.a.resize(p.nodes.size());
+            p.b.resize(p.nodes.size());
+            p.c.resize(p.nodes.size());
+            columns = ",energy_J_per_m";
+        } else {
+            // Outward S.n with Sx = -Ez*Hy and Sy = Ez*Hx (TMz); H is stored as eta0*H
+            p.kind = Kind::Flux;
+            for (int j = j0; j <= j1; ++j) {
+                const float len = static_cast<float>(sim.cellWidthY(j) / eta0);
+                p.nodes_x.push_back(node(i1, j)); p.coef_x.push_back(-len);
+                p.nodes_x.push_back(node(i0, j)); p.coef_x.push_back(len);
+            }
+            for (int i = i0; i <= i1; ++i) {
+                const float len = static_cast<float>(sim.cellWidthX(i) / eta0);
+                p.nodes_y.push_back(node(i, j1)); p.coef_y.push_back(len);
+                p.nodes_y.push_back(node(i, j0)); p.coef_y.push_back(-len);
+            }
+            p.a.resize(std::max(p.nodes_x.size(), p.nodes_y.size()));
+            p.b.resize(p.a.size());
+            columns = ",flux_W_per_m";
+        }
+        p.width = 1;
+    } else {
+        std::cout << "Probe '" << c.name << "': unknown type '" << c.type << "' - ignored" << std::endl;
+        return false;
+    }
+
+    p.out.open(conf.dir + "/" + c.name + ".csv", std::ios::trunc);
+    if (!p.out) {
+        std::cerr << "Could not open " << conf.dir << "/" << c.name << ".csv - probe ignored\n";
+        return false;
+    }
+    p.out << header << columns << "\n";
+    return true;
+}
+
+void ProbeSet::measure(const FDTD &sim, Probe &p, float *out) {
+    switch (p.kind) {
+    case Kind::Field:
+        sim.gatherMesh(p.field, p.nodes, out);
+        break;
+    case Kind::Energy: {
+        sim.gatherMesh(YeeField::Ez, p.nodes, p.a.data());
+        sim.gatherMesh(YeeField::Hx, p.nodes, p.b.data());
+        sim.gatherMesh(YeeField::Hy, p.nodes, p.c.data());
+        const float *eps = sim.meshEpsR().data();
+        double sum = 0.0;
+        for (size_t k = 0; k < p.nodes.size(); ++k) {
+            sum += p.weights[k] * (eps[p.nodes[k]] * p.a[k] * p.a[k] + p.b[k] * p.b[k] + p.c[k] * p.c[k]);
+        }
+        out[0] = static_cast<float>(0.5 * eps0 * sum);
+        break;
+    }
+    case Kind::Flux: {
+        double sum = 0.0;
+        sim.gatherMesh(YeeField::Ez, p.nodes_x, p.a.data());
+        sim.gatherMesh(YeeField::Hy, p.nodes_x, p.b.data());
+        for (size_t k = 0; k < p.nodes_x.size(); ++k) sum += p.coef_x[k] * p.a[k] * p.b[k];
+        sim.gatherMesh(YeeField::Ez, p.nodes_y, p.a.data());
+        sim.gatherMesh(YeeField::Hx, p.nodes_y, p.b.data());
+        for (size_t k = 0; k < p.nodes_y.size(); ++k) sum += p.coef_y[k] * p.a[k] * p.b[k];
+        out[0] = static_cast<float>(sum);
+        break;
+    }
+    }
+}
+
+void ProbeSet::sample(const FDTD &sim) {
+    if (probes.empty()) return;
+    const long long step = sim.getStep();
+    if (step % conf.interval != 0) return;
+    auto start = std::chrono::steady_clock::now();
+    bool wake = false;
+    for (auto &p : probes) {
+        const size_t head = p->head.load(std::memory_order_relaxed);
+        if (head - p->tail.load(std::memory_order_acquire) >= capacity) waitForSpace(*p, head);
+        const size_t slot = head % capacity;
+        p->steps[slot] = step;
+        measure(sim, *p, &p->values[slot * p->width]);
+        p->head.store(head + 1, std::memory_order_release);
+        wake |= (head + 1) % batch == 0;
+    }
+    if (wake) {
+        { std::lock_guard<std::mutex> lock(m); }  // Orders the head updates before the writer's predicate check
+        wake_cv.notify_one();
+    }
+    ++samples;
+    sample_s += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void ProbeSet::waitForSpace(Probe &p, size_t head) {
+    auto start = std::chrono::steady_clock::now();
+    std::unique_lock<std::mutex> lock(m);
+    flush_requested = true;
+    wake_cv.notify_one();
+    space_cv.wait(lock, [&] { return head - p.tail.load(std::memory_order_acquire) < capacity; });
+    ++stalls;
+    stalled_s += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void ProbeSet::drain(Probe &p, std::string &text) {
+    const size_t head = p.head.load(std::memory_order_acquire);
+    const size_t tail = p.tail.load(std::memory_order_relaxed);
+    if (head == tail) return;
+    text.clear();
+    char num[32];
+    for (size_t k = tail; k < head; ++k) {
+        const size_t slot = k % capacity;
+        std::snprintf(num, sizeof(num), "%lld,%.9g", p.steps[slot], p.steps[slot] * dt);
+        text += num;
+        const float *v = &p.values[slot * p.width];
+        for (int c = 0; c < p.width; ++c) {
+            std::snprintf(num, sizeof(num), ",%.7g", v[c]);
+            text += num;
+        }
+        text += '\n';
+    }
+    p.tail.store(head, std::memory_order_release);  // Slots are free again once formatted
+    p.out.write(text.data(), static_cast<std::streamsize>(text.size()));
+    p.out.flush();
+    rows_written += head - tail;
+    bytes_written += text.size();
+}
+
+void ProbeSet::writerLoop() {
+    std::string text;  // Reused across batches
+    while (true) {
+        bool quit;
+        {
+            std::unique_lock<std::mutex> lock(m);
+            wake_cv.wait(lock, [this] {
+                if (stopping || flush_requested) return true;
+                for (const auto &p : probes) {
+                    if (p->head.load(std::memory_order_acquire) - p->tail.load(std::memory_order_relaxed) >= batch) return true;
+                }
+                return false;
+            });
+            quit = stopping;
+            flush_requested = false;
+        }
+        auto start = std::chrono::steady_clock::now();
+        for (auto &p : probes) drain(*p, text);
+        write_s += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        { std::lock_guard<std::mutex> lock(m); }
+        space_cv.notify_all();
+        if (quit) return;
+    }
+}
+
+void ProbeSet::finish() {
+    if (probes.empty() || !writer.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(m);
+        stopping = true;
+    }
+    wake_cv.notify_all();
+    writer.join();
+    const size_t count = probes.size();
+    probes.clear();  // Closes the files; later steps are no longer sampled
+
+    std::cout << "?? Probes: " << count << " probes, " << samples << " samples, " << rows_written << " rows, "
+              << std::fixed << std::setprecision(1) << bytes_written / (1024.0 * 1024.0) << " MB to " << conf.dir << "/" << std::endl;
+    std::cout << "   Sampling " << std::setprecision(2) << (samples ? 1e6 * (sample_s - stalled_s) / samples : 0.0)
+              << " us per sampled step, writer busy " << std::setprecision(3) << write_s << " s, "
+              << stalls << " stalls on a full ring (" << std::setprecision(1) << 1000.0 * stalled_s << "ms)"
+              << std::defaultfloat << std::setprecision(6) << std::endl;
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Config.hpp"
+
+class FDTD;
+enum class YeeField;
+
+// Field probes and region monitors of an in-memory time-domain run
+// Node lists and weights are resolved once, so sample() - called by FDTD after
+// every time step - only gathers a few values per probe into its preallocated
+// ring buffer; cost follows the probe sizes, not the grid. A writer thread
+// drains the rings in batches to <dir>/<name>.csv. A full ring stalls the time
+// loop until the writer catches up, so no sample is lost.
+class ProbeSet {
+public:
+    ProbeSet(const ProbeSetConfig &conf, const FDTD &sim);
+    ~ProbeSet();
+    ProbeSet(const ProbeSet&) = delete;
+    ProbeSet& operator=(const ProbeSet&) = delete;
+
+    bool enabled() const { return !probes.empty(); }
+    void sample(const FDTD &sim);
+    void finish();  // Flushes every ring and prints recording statistics
+
+private:
+    enum class Kind { Field, Energy, Flux };
+
+    struct Probe {
+        ProbeConfig conf;
+        Kind kind = Kind::Field;
+        YeeField field{};
+        int width = 1;                       // Values per sample
+        std::vector<size_t> nodes;           // Field / Energy nodes
+        std::vector<float> weights;          // Energy: dual-cell area per node
+        std::vector<size_t> nodes_x, nodes_y;  // Flux: nodes on the x = const / y = const edges
+        std::vector<float> coef_x, coef_y;     // Flux: signed edge length over eta0
+        std::vector<float> a, b, c;          // Gather scratch
+
+        std::vector<long long> steps;        // Ring of `capacity` samples
+        std::vector<float> values;           // capacity x width
+        std::atomic<size_t> head{0}, tail{0};  // Written by sample() / by the writer
+        std::ofstream out;
+    };
+
+    ProbeSetConfig conf;
+    double dt = 0.0;
+    size_t capacity = 0, batch = 0;
+    std::vector<std::unique_ptr<Probe>> probes;
+
+    std::mutex m;
+    std::condition_variable wake_cv, space_cv;
+    bool stopping = false;
+    bool flush_requested = false;
+    std::thread writer;
+
+    // Time loop side
+    size_t samples = 0, stalls = 0;
+    double sample_s = 0.0, stalled_s = 0.0;
+    // Writer side, read after join
+    size_t rows_written = 0, bytes_written = 0;
+    double write_s = 0.0;
+
+    bool build(Probe &p, const FDTD &sim);
+    void measure(const FDTD &sim, Probe &p, float *out);
+    void waitForSpace(Probe &p, size_t head);
+    void drain(Probe &p, std::string &text);
+    void writerLoop();
+};
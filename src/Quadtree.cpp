@@ -0,0 +1,185 @@
+#include "Quadtree.hpp"
+#include "Dipole.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <execution>
+#include <iostream>
+#include <numeric>
+
+QuadtreeField::QuadtreeField(int nx_, int ny_, const AdaptiveConfig &conf)
+: nx(nx_), ny(ny_), m(std::clamp(conf.tile_samples, 2, 64)),
+  max_level(std::max(conf.max_level, 0)), tolerance(static_cast<float>(conf.tolerance)) {
+    root_size = m;
+    while (root_size < std::max(nx, ny)) root_size *= 2;
+
+    // Display grid keeps the domain aspect ratio; huge domains are downsampled on rasterization
+    const int longest = std::max(nx, ny);
+    const double scale = std::min(1.0, static_cast<double>(std::max(conf.display_max, 16)) / longest);
+    display_w = std::max(1, static_cast<int>(std::lround(nx * scale)));
+    display_h = std::max(1, static_cast<int>(std::lround(ny * scale)));
+
+    std::cout << "Adaptive quadtree field: " << nx << "x" << ny << " domain, root tile " << root_size
+              << ", " << m << "x" << m << " lattice per tile, tolerance " << tolerance
+              << ", display " << display_w << "x" << display_h << std::endl;
+}
+
+void QuadtreeField::build(const std::vector<MagnetConfig> &magnets) {
+    const auto poles = dipole::poles<float>(magnets);
+    auto start = std::chrono::high_resolution_clock::now();
+    const int stride = m + 1;
+    const size_t lattice = static_cast<size_t>(stride) * stride;
+
+    nodes.clear();
+    leaves.clear();
+    samples.clear();
+    nodes.push_back({0, 0, root_size});
+
+    // Breadth-first refinement: every tile of a level is sampled and tested in parallel,
+    // then the accepted ones become leaves and the rest spawn the next level
+    std::vector<int> frontier = {0};
+    std::vector<float> scratch;
+    std::vector<int> verdict;     // 0 = leaf, 1 = split, 2 = outside the domain
+    std::vector<int> evaluations;
+    std::vector<size_t> slots;    // Frontier indices driving the parallel pass
+    size_t total_evaluations = 0;
+    int depth = 0;
+
+    for (int level = 0; !frontier.empty(); ++level) {
+        scratch.resize(frontier.size() * lattice);
+        verdict.assign(frontier.size(), 0);
+        evaluations.assign(frontier.size(), 0);
+        slots.resize(frontier.size());
+        std::iota(slots.begin(), slots.end(), size_t(0));
+
+        std::for_each(std::execution::par_unseq, slots.begin(), slots.end(), [&](size_t k) {
+            const int n = frontier[k];
+            const Node node = nodes[n];
+            if (node.x0 >= nx || node.y0 >= ny) {
+                verdict[k] = 2;
+                return;
+            }
+
+            const double h = static_cast<double>(node.size) / m;
+            float *lat = &scratch[k * lattice];
+            for (int b = 0; b <= m; ++b) {
+                for (int a = 0; a <= m; ++a) {
+                    lat[b * stride + a] = dipole::field<float>(node.x0 + a * h, node.y0 + b * h, poles);
+                }
+            }
+            evaluations[k] = static_cast<int>(lattice);
+            if (h <= 1.0 || level >= max_level) return; // Display resolution reached
+
+            // Pole markers are discontinuous, so tiles touching a magnet always split
+            const double margin = std::sqrt(dipole::min_distance_sq) + h;
+            for (const auto &magnet : magnets) {
+                if (magnet.x >= node.x0 - margin && magnet.x <= node.x0 + node.size + margin &&
+                    magnet.y >= node.y0 - margin && magnet.y <= node.y0 + node.size + margin) {
+                    verdict[k] = 1;
+                    return;
+                }
+            }
+
+            // Error estimate: bilinear prediction against the true field at each lattice cell centre
+            for (int b = 0; b < m; ++b) {
+                for (int a = 0; a < m; ++a) {
+                    const float *q = &lat[b * stride + a];
+                    const float predicted = 0.25f * (q[0] + q[1] + q[stride] + q[stride + 1]);
+                    const float actual = dipole::field<float>(node.x0 + (a + 0.5) * h, node.y0 + (b + 0.5) * h, poles);
+                    ++evaluations[k];
+                    if (std::abs(actual - predicted) > tolerance) {
+                        verdict[k] = 1;
+                        return;
+                    }
+                }
+            }
+        });
+
+        std::vector<int> next;
+        for (size_t k = 0; k < frontier.size(); ++k) {
+            const int n = frontier[k];
+            total_evaluations += evaluations[k];
+            if (verdict[k] == 2) continue;
+            if (verdict[k] == 1) {
+                const Node parent = nodes[n];
+                const int half = parent.size / 2;
+                nodes[n].child = static_cast<int>(nodes.size());
+                for (int q = 0; q < 4; ++q) {
+                    next.push_back(static_cast<int>(nodes.size()));
+                    nodes.push_back({parent.x0 + (q & 1) * half, parent.y0 + (q >> 1) * half, half});
+                }
+                continue;
+            }
+            nodes[n].leaf = static_cast<int>(leaves.size());
+            leaves.push_back(n);
+            samples.insert(samples.end(), scratch.begin() + k * lattice, scratch.begin() + (k + 1) * lattice);
+        }
+        depth = level;
+        frontier.swap(next);
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    const double ms = std::chrono::duration<double, std::milli>(end - start).count();
+    const double uniform_mb = static_cast<double>(nx) * ny * sizeof(float) / (1024.0 * 1024.0);
+    std::cout << "Adaptive field built in " << ms << "ms: " << leaves.size() << " leaves over " << (depth + 1)
+              << " levels, " << total_evaluations << " dipole evaluations ("
+              << (100.0 * total_evaluations / (static_cast<double>(nx) * ny)) << "% of a uniform solve)" << std::endl;
+    std::cout << "   Memory: " << (memoryBytes() / 1024) << " KB vs " << uniform_mb << " MB for the uniform grid" << std::endl;
+}
+
+float QuadtreeField::interpolate(const Node &node, double x, double y) const {
+    const double h = static_cast<double>(node.size) / m;
+    const double u = (x - node.x0) / h;
+    const double v = (y - node.y0) / h;
+    const int a = std::clamp(static_cast<int>(u), 0, m - 1);
+    const int b = std::clamp(static_cast<int>(v), 0, m - 1);
+    const float fu = static_cast<float>(u - a);
+    const float fv = static_cast<float>(v - b);
+
+    const int stride = m + 1;
+    const float *q = &samples[static_cast<size_t>(node.leaf) * stride * stride + b * stride + a];
+    const float top = q[0] + fu * (q[1] - q[0]);
+    const float bottom = q[stride] + fu * (q[stride + 1] - q[stride]);
+    return top + fv * (bottom - top);
+}
+
+float QuadtreeField::sample(double x, double y) const {
+    if (nodes.empty() || x < 0.0 || y < 0.0 || x >= nx || y >= ny) return 0.0f;
+    const Node *node = &nodes[0];
+    while (node->child >= 0) {
+        const int half = node->size / 2;
+        const int q = (x >= node->x0 + half ? 1 : 0) + (y >= node->y0 + half ? 2 : 0);
+        node = &nodes[node->child + q];
+    }
+    return node->leaf >= 0 ? interpolate(*node, x, y) : 0.0f;
+}
+
+void QuadtreeField::rasterize(std::vector<float> &out, int w, int h) const {
+    out.assign(static_cast<size_t>(w) * h, 0.0f);
+    if (leaves.empty()) return;
+
+    // Pixel I samples domain coordinate (I + 0.5) * scale - 0.5; a leaf owns the pixels whose
+    // coordinate falls in [x0, x0 + size), so neighbouring leaves partition the image exactly
+    const double sx = static_cast<double>(nx) / w;
+    const double sy = static_cast<double>(ny) / h;
+    auto firstPixel = [](double x, double s, int n) {
+        return std::clamp(static_cast<int>(std::ceil((x + 0.5) / s - 0.5)), 0, n);
+    };
+
+    std::for_each(std::execution::par_unseq, leaves.begin(), leaves.end(), [&](const int &n) {
+        const Node &node = nodes[n];
+        const int i0 = firstPixel(node.x0, sx, w), i1 = firstPixel(node.x0 + node.size, sx, w);
+        const int j0 = firstPixel(node.y0, sy, h), j1 = firstPixel(node.y0 + node.size, sy, h);
+        for (int J = j0; J < j1; ++J) {
+            const double y = (J + 0.5) * sy - 0.5;
+            float *row = &out[static_cast<size_t>(J) * w];
+            for (int I = i0; I < i1; ++I) {
+                row[I] = interpolate(node, (I + 0.5) * sx - 0.5, y);
+            }
+        }
+    });
+}
+
+size_t QuadtreeField::memoryBytes() const {
+    return nodes.size() * sizeof(Node) + leaves.size() * sizeof(int) + samples.size() * sizeof(float);
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include "Config.hpp"
+
+// Adaptive quadtree representation of the static magnet field
+// Every leaf tile stores an (m+1)x(m+1) lattice of dipole field samples and is
+// read back by bilinear interpolation. Tiles split while the interpolation error
+// at the lattice cell centres exceeds the tolerance or a magnet pole lies inside;
+// once the lattice spacing reaches one display cell the samples are exact.
+// Memory and evaluation cost follow field complexity rather than nx*ny.
+class QuadtreeField {
+public:
+    QuadtreeField() = default;
+    QuadtreeField(int nx, int ny, const AdaptiveConfig &conf);
+
+    bool enabled() const { return nx > 0; }
+    void build(const std::vector<MagnetConfig> &magnets);
+
+    // Field at display coordinate (x, y); 0 outside the domain or before build()
+    float sample(double x, double y) const;
+
+    // Bulk resampling onto a w x h grid covering the domain (pixel centres),
+    // filled leaf by leaf so each tile's lattice is located only once
+    void rasterize(std::vector<float> &out, int w, int h) const;
+
+    int displayWidth() const { return display_w; }
+    int displayHeight() const { return display_h; }
+    size_t leafCount() const { return leaves.size(); }
+    size_t memoryBytes() const;
+
+private:
+    struct Node {
+        int x0 = 0, y0 = 0, size = 0;
+        int child = -1;  // First of four children (NW, NE, SW, SE) in nodes
+        int leaf = -1;   // Sample lattice index; -1 for interior nodes and tiles outside the domain
+    };
+
+    int nx = 0, ny = 0;
+    int m = 8;               // Lattice intervals per tile edge
+    int root_size = 0;       // Power-of-two multiple of m covering the domain
+    int max_level = 16;
+    float tolerance = 0.01f;
+    int display_w = 0, display_h = 0;
+
+    std::vector<Node> nodes;
+    std::vector<int> leaves;     // Node index of each leaf
+    std::vector<float> samples;  // (m+1)^2 values per leaf, row-major
+
+    float interpolate(const Node &node, double x, double y) const;
+};
@@ -1,4 +1,6 @@
 #include "Renderer.hpp"
+#include "Colormap.hpp"
+#include "FluxLines.hpp"
 #include <algorithm>
 #include <iostream>
 #include <sstream>
@@ -18,6 +20,8 @@ Renderer::Renderer(int nx_, int ny_, double color_range_)
     // Create texture from image
     texture = LoadTextureFromImage(image);
     
+    buildColorLut();
+    
     // Enable high-quality texture filtering for ultra-smooth antialiasing
     SetTextureFilter(texture, TEXTURE_FILTER_BILINEAR);
     
@@ -40,6 +44,7 @@ Renderer::~Renderer() {
 
 void Renderer::setColorRange(double new_range) {
     color_range = new_range;
+    buildColorLut();
     // Reduced logging for better performance in interactive mode
     static int log_counter = 0;
     if (++log_counter % 10 == 0) {  // Log every 10th change
@@ -47,86 +52,52 @@ void Renderer::setColorRange(double new_range) {
     }
 }
 
-Color Renderer::mapValue(float v) {
-    // Normalize to color range with optimized clamping
-    float normalized = v / static_cast<float>(color_range);
-    normalized = std::clamp(normalized, -1.0f, 1.0f);
-    
-    // Enhanced ultra-high resolution color mapping with smoother gradients
-    const float abs_norm = std::abs(normalized);
-    
-    // Ultra-fine zero field detection for high resolution detail
-    if (abs_norm < 0.005f) {
-        // Very near zero: sophisticated dark blue-green gradient
-        unsigned char intensity = static_cast<unsigned char>(32 + 32 * abs_norm / 0.005f);
-        return Color{0, intensity, static_cast<unsigned char>(intensity + 16), 255};
+void Renderer::buildColorLut() {
+    const float range = static_cast<float>(color_range);
+    color_lut.resize(lut_size);
+    for (int k = 0; k < lut_size; ++k) {
+        const float v = range * (2.0f * k / (lut_size - 1) - 1.0f);
+        const colormap::RGBA c = colormap::map(v, range);
+        color_lut[k] = Color{c.r, c.g, c.b, c.a};
     }
-    
-    if (normalized < -0.85f) {
-        // Ultra-strong negative field: Deep blue to violet
-        float t = (abs_norm - 0.85f) / 0.15f;
-        unsigned char red = static_cast<unsigned char>(32 + 96 * t);
-        unsigned char green = static_cast<unsigned char>(16 * t);
-        unsigned char blue = 255;
-        return Color{red, green, blue, 255};
-    } else if (normalized < -0.6f) {
-        // Very strong negative field: Blue to deep blue
-        float t = (abs_norm - 0.6f) / 0.25f;
-        unsigned char red = static_cast<unsigned char>(8 * t);
-        unsigned char green = static_cast<unsigned char>(8 * t);
-        unsigned char blue = static_cast<unsigned char>(180 + 75 * t);
-        return Color{red, green, blue, 255};
-    } else if (normalized < -0.3f) {
-        // Strong negative field: Cyan to blue transition
-        float t = (abs_norm - 0.3f) / 0.3f;
-        unsigned char red = 0;
-        unsigned char green = static_cast<unsigned char>(128 * (1.0f - t));
-        unsigned char blue = static_cast<unsigned char>(128 + 127 * t);
-        return Color{red, green, blue, 255};
-    } else if (normalized < -0.1f) {
-        // Medium negative field: Green-cyan to cyan transition
-        float t = (abs_norm - 0.1f) / 0.2f;
-        unsigned char red = 0;
-        unsigned char green = static_cast<unsigned char>(64 + 64 * t);
-        unsigned char blue = static_cast<unsigned char>(96 + 32 * t);
-        return Color{red, green, blue, 255};
-    } else if (normalized < 0.1f) {
-        // Near zero field: Enhanced neutral field visualization
-        float t = abs_norm / 0.1f;
-        unsigned char base_intensity = static_cast<unsigned char>(48 + 48 * t);
-        return Color{base_intensity, static_cast<unsigned char>(base_intensity + 16), base_intensity, 255};
-    } else if (normalized < 0.3f) {
-        // Medium positive field: Green to yellow transition
-        float t = (abs_norm - 0.1f) / 0.2f;
-        unsigned char red = static_cast<unsigned char>(64 + 96 * t);
-        unsigned char green = static_cast<unsigned char>(128 + 64 * t);
-        unsigned char blue = static_cast<unsigned char>(32 * (1.0f - t));
-        return Color{red, green, blue, 255};
-    } else if (normalized < 0.6f) {
-        // Strong positive field: Yellow to orange transition
-        float t = (abs_norm - 0.3f) / 0.3f;
-        unsigned char red = static_cast<unsigned char>(160 + 95 * t);
-        unsigned char green = static_cast<unsigned char>(192 * (1.0f - 0.4f * t));
-        unsigned char blue = 0;
-        return Color{red, green, blue, 255};
-    } else if (normalized < 0.85f) {
-        // Very strong positive field: Orange to red
-        float t = (abs_norm - 0.6f) / 0.25f;
-        unsigned char red = 255;
-        unsigned char green = static_cast<unsigned char>(128 * (1.0f - t));
-        unsigned char blue = static_cast<unsigned char>(32 * t);
-        return Color{red, green, blue, 255};
-    } else {
-        // Ultra-strong positive field: Red to bright red-white
-        float t = (abs_norm - 0.85f) / 0.15f;
-        unsigned char red = 255;
-        unsigned char green = static_cast<unsigned char>(64 * t);
-        unsigned char blue = static_cast<unsigned char>(64 * t);
-        return Color{red, green, blue, 255};
+    lut_scale = (lut_size - 1) / (2.0f * range);
+}
+
+Color Renderer::mapValue(float v) const {
+    // Nearest table entry; values outside the range (and NaN) land on the end entries
+    const float t = std::min(static_cast<float>(lut_size - 1),
+                             std::max(0.0f, (v + static_cast<float>(color_range)) * lut_scale + 0.5f));
+    return color_lut[static_cast<int>(t)];
+}
+
+void Renderer::drawFluxLines(const FluxLines &lines, float offset_x, float offset_y, float scale) {
+    if (lines.version() != line_version || scale != line_scale || offset_x != line_x || offset_y != line_y) {
+        line_points.clear();
+        line_starts.clear();
+        line_points.reserve(lines.totalPoints());
+        for (size_t l = 0; l < lines.lineCount(); ++l) {
+            if (lines.pointCount(l) < 2) continue;
+            line_starts.push_back(static_cast<int>(line_points.size()));
+            const float *xs = lines.xs(l), *ys = lines.ys(l);
+            // Node (i, j) is the centre of texel (i, j)
+            for (int k = 0; k < lines.pointCount(l); ++k) {
+                line_points.push_back(Vector2{offset_x + (xs[k] + 0.5f) * scale, offset_y + (ys[k] + 0.5f) * scale});
+            }
+        }
+        line_starts.push_back(static_cast<int>(line_points.size()));
+        line_version = lines.version();
+        line_scale = scale;
+        line_x = offset_x;
+        line_y = offset_y;
+    }
+    // One strip per line; raylib batches them into a few draw calls
+    const Color line_color{235, 235, 235, 110};
+    for (size_t l = 0; l + 1 < line_starts.size(); ++l) {
+        DrawLineStrip(&line_points[line_starts[l]], line_starts[l + 1] - line_starts[l], line_color);
     }
 }
 
-void Renderer::render(const std::vector<float> &Ez) {
+void Renderer::render(const std::vector<float> &Ez, const FluxLines *lines) {
     static int frame_count = 0;
     static int performance_samples = 0;
     static double total_render_time = 0.0;
@@ -192,6 +163,7 @@ void Renderer::render(const std::vector<float> &Ez) {
     
     // Draw with ultra-high quality antialiasing
     DrawTextureEx(texture, Vector2{offset_x, offset_y}, 0.0f, scale, WHITE);
+    if (lines) drawFluxLines(*lines, offset_x, offset_y, scale);
     
     // Enhanced professional UI for ultra-high resolution
     DrawText("Ultra-High Resolution Magnetic Field Simulator - FEMM Clone", 10, 10, 28, WHITE);
@@ -254,7 +226,7 @@ void Renderer::render(const std::vector<float> &Ez) {
     DrawText("Strong", bar_x + bar_width - quarter/2 - 25, bar_y + 45, 12, LIGHTGRAY);
     
     // Enhanced control instructions
-    DrawText("?? Controls: ???? (coarse 0.05) | ???? (fine 0.02) | ?? R (reset) | ? ESC (quit)", 
+    DrawText("?? Controls: ???? (coarse 0.05) | ???? (fine 0.02) | ?? R (reset) | F (flux lines) | ? ESC (quit)", 
              10, window_height - 30, 16, WHITE);
     
     // Ultra-high resolution quality indicator
@@ -4,6 +4,8 @@
 #include <vector>
 #include <chrono>
 
+class FluxLines;
+
 // Ultra-High Resolution Magnetic Field Renderer
 // Version: 2.0 - Professional FEMM-style visualization
 // Features: 1024x1024 resolution, bilinear antialiasing, adaptive performance
@@ -12,7 +14,7 @@ class Renderer {
 public:
     Renderer(int nx, int ny, double color_range = 1.0);
     ~Renderer();
-    void render(const std::vector<float> &Ez);
+    void render(const std::vector<float> &Ez, const FluxLines *lines = nullptr);  // Optional flux-line overlay
     void setColorRange(double new_range); // New method for adjustable bounds
     double getColorRange() const { return color_range; }
 
@@ -23,5 +25,18 @@ private:
     Texture2D texture;
     bool texture_needs_update;
 
-    Color mapValue(float v);
+    // Flux-line vertices in screen space, rebuilt when the lines or the texture placement change
+    std::vector<Vector2> line_points;
+    std::vector<int> line_starts;
+    unsigned long long line_version = ~0ull;
+    float line_scale = 0.0f, line_x = 0.0f, line_y = 0.0f;
+
+    // Colour map sampled over [-color_range, color_range]; only a range change rebuilds it
+    static constexpr int lut_size = 8192;
+    std::vector<Color> color_lut;
+    float lut_scale = 0.0f;
+
+    void buildColorLut();
+    Color mapValue(float v) const;
+    void drawFluxLines(const FluxLines &lines, float offset_x, float offset_y, float scale);
 };
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Thread-safe free list of reusable objects (field buffers, solver instances)
+template <typename T>
+class ResourcePool {
+public:
+    // nullptr when the pool is empty - the caller creates a new object and releases it afterwards
+    std::unique_ptr<T> acquire() {
+        std::lock_guard<std::mutex> lock(m);
+        if (free_items.empty()) {
+            ++misses;
+            return nullptr;
+        }
+        auto item = std::move(free_items.back());
+        free_items.pop_back();
+        ++hits;
+        return item;
+    }
+    void release(std::unique_ptr<T> item) {
+        std::lock_guard<std::mutex> lock(m);
+        free_items.push_back(std::move(item));
+    }
+    size_t created() const { return misses; }
+    size_t reused() const { return hits; }
+
+private:
+    std::mutex m;
+    std::vector<std::unique_ptr<T>> free_items;
+    size_t hits = 0, misses = 0;
+};
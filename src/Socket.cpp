@@ -0,0 +1,256 @@
+#include "Socket.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "ws2_32.lib")
+using socket_t = SOCKET;
+#define EM2D_CLOSE_SOCKET closesocket
+#else
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+using socket_t = int;
+#define EM2D_CLOSE_SOCKET ::close
+#endif
+
+namespace {
+#ifdef _WIN32
+struct WinsockInit {
+    WinsockInit() { WSADATA data; WSAStartup(MAKEWORD(2, 2), &data); }
+    ~WinsockInit() { WSACleanup(); }
+};
+#endif
+
+void ensureInit() {
+#ifdef _WIN32
+    static WinsockInit init;
+#endif
+}
+
+bool splitTcp(const std::string &endpoint, std::string &host, std::string &port) {
+    if (endpoint.rfind("tcp:", 0) != 0) return false;
+    const std::string rest = endpoint.substr(4);
+    const size_t colon = rest.rfind(':');
+    if (colon == std::string::npos) return false;
+    host = rest.substr(0, colon);
+    port = rest.substr(colon + 1);
+    return !host.empty() && !port.empty();
+}
+
+bool waitFor(long long fd, bool write, int timeout_ms) {
+#ifdef _WIN32
+    WSAPOLLFD p{static_cast<SOCKET>(fd), static_cast<SHORT>(write ? POLLOUT : POLLIN), 0};
+    return WSAPoll(&p, 1, timeout_ms) > 0;
+#else
+    pollfd p{static_cast<int>(fd), static_cast<short>(write ? POLLOUT : POLLIN), 0};
+    return poll(&p, 1, timeout_ms) > 0;
+#endif
+}
+
+void setNoDelay(long long fd) {
+    int one = 1;
+    setsockopt(static_cast<socket_t>(fd), IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&one), sizeof(one));
+}
+}
+
+Socket::~Socket() {
+    close();
+}
+
+Socket::Socket(Socket &&other) noexcept : fd(other.fd), bound(std::move(other.bound)), unix_path(std::move(other.unix_path)) {
+    other.fd = -1;
+    other.unix_path.clear();
+}
+
+Socket& Socket::operator=(Socket &&other) noexcept {
+    if (this != &other) {
+        close();
+        fd = other.fd;
+        bound = std::move(other.bound);
+        unix_path = std::move(other.unix_path);
+        other.fd = -1;
+        other.unix_path.clear();
+    }
+    return *this;
+}
+
+void Socket::shutdown() {
+#ifdef _WIN32
+    if (fd >= 0) ::shutdown(static_cast<socket_t>(fd), SD_BOTH);
+#else
+    if (fd >= 0) ::shutdown(static_cast<socket_t>(fd), SHUT_RDWR);
+#endif
+}
+
+void Socket::close() {
+    if (fd >= 0) EM2D_CLOSE_SOCKET(static_cast<socket_t>(fd));
+    fd = -1;
+#ifndef _WIN32
+    if (!unix_path.empty()) unlink(unix_path.c_str());
+#endif
+    unix_path.clear();
+}
+
+Socket Socket::listen(const std::string &endpoint) {
+    ensureInit();
+    Socket s;
+    std::string host, port;
+    if (endpoint.rfind("unix:", 0) == 0) {
+#ifdef _WIN32
+        std::cerr << "Unix domain sockets are not available on Windows: " << endpoint << "\n";
+        return s;
+#else
+        const std::string path = endpoint.substr(5);
+        sockaddr_un addr{};
+        if (path.empty() || path.size() >= sizeof(addr.sun_path)) {
+            std::cerr << "Invalid Unix socket path: " << endpoint << "\n";
+            return s;
+        }
+        addr.sun_family = AF_UNIX;
+        std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+        unlink(path.c_str());  // Stale socket of an earlier run
+        const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0 || bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || ::listen(fd, 4) != 0) {
+            std::cerr << "Could not listen on " << endpoint << ": " << std::strerror(errno) << "\n";
+            if (fd >= 0) ::close(fd);
+            return s;
+        }
+        s.fd = fd;
+        s.bound = endpoint;
+        s.unix_path = path;
+        return s;
+#endif
+    }
+    if (!splitTcp(endpoint, host, port)) {
+        std::cerr << "Unsupported endpoint '" << endpoint << "' (use tcp:host:port or unix:/path)\n";
+        return s;
+    }
+
+    addrinfo hints{}, *res = nullptr;
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_PASSIVE;
+    if (getaddrinfo(host.c_str(), port.c_str(), &hints, &res) != 0 || !res) {
+        std::cerr << "Could not resolve " << endpoint << "\n";
+        return s;
+    }
+    const socket_t fd = socket(res->ai_family, res->ai_socktype, res->ai_protocol);
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&one), sizeof(one));
+    const bool ok = bind(fd, res->ai_addr, static_cast<int>(res->ai_addrlen)) == 0 && ::listen(fd, 4) == 0;
+    freeaddrinfo(res);
+    if (!ok) {
+        std::cerr << "Could not listen on " << endpoint << "\n";
+        EM2D_CLOSE_SOCKET(fd);
+        return s;
+    }
+    s.fd = static_cast<long long>(fd);
+
+    sockaddr_in addr{};
+    socklen_t len = sizeof(addr);
+    getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len);
+    s.bound = "tcp:" + host + ":" + std::to_string(ntohs(addr.sin_port));
+    return s;
+}
+
+Socket Socket::connect(const std::string &endpoint) {
+    ensureInit();
+    Socket s;
+    std::string host, port;
+    if (endpoint.rfind("unix:", 0) == 0) {
+#ifndef _WIN32
+        sockaddr_un addr{};
+        const std::string path = endpoint.substr(5);
+        if (path.empty() || path.size() >= sizeof(addr.sun_path)) return s;
+        addr.sun_family = AF_UNIX;
+        std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+        const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0 || ::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+            if (fd >= 0) ::close(fd);
+            return s;
+        }
+        s.fd = fd;
+        s.bound = endpoint;
+#endif
+        return s;
+    }
+    if (!splitTcp(endpoint, host, port)) {
+        std::cerr << "Unsupported endpoint '" << endpoint << "' (use tcp:host:port or unix:/path)\n";
+        return s;
+    }
+    addrinfo hints{}, *res = nullptr;
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    if (getaddrinfo(host.c_str(), port.c_str(), &hints, &res) != 0 || !res) return s;
+    const socket_t fd = socket(res->ai_family, res->ai_socktype, res->ai_protocol);
+    const bool ok = ::connect(fd, res->ai_addr, static_cast<int>(res->ai_addrlen)) == 0;
+    freeaddrinfo(res);
+    if (!ok) {
+        EM2D_CLOSE_SOCKET(fd);
+        return s;
+    }
+    s.fd = static_cast<long long>(fd);
+    s.bound = endpoint;
+    setNoDelay(s.fd);
+    return s;
+}
+
+Socket Socket::accept(int timeout_ms) {
+    Socket client;
+    if (fd < 0 || !waitFor(fd, false, timeout_ms)) return client;
+    const socket_t c = ::accept(static_cast<socket_t>(fd), nullptr, nullptr);
+#ifdef _WIN32
+    if (c == INVALID_SOCKET) return client;
+#else
+    if (c < 0) return client;
+#endif
+    client.fd = static_cast<long long>(c);
+    client.bound = bound;
+    if (unix_path.empty()) setNoDelay(client.fd);
+    return client;
+}
+
+bool Socket::readable(int timeout_ms) {
+    return fd >= 0 && waitFor(fd, false, timeout_ms);
+}
+
+bool Socket::sendAll(const void *data, size_t bytes) {
+    const char *p = static_cast<const char*>(data);
+    while (bytes > 0 && fd >= 0) {
+#ifdef _WIN32
+        const int n = send(static_cast<socket_t>(fd), p, static_cast<int>(std::min<size_t>(bytes, 1 << 30)), 0);
+#else
+        const ssize_t n = send(static_cast<socket_t>(fd), p, bytes, MSG_NOSIGNAL);
+#endif
+        if (n <= 0) return false;
+        p += n;
+        bytes -= static_cast<size_t>(n);
+    }
+    return fd >= 0;
+}
+
+bool Socket::recvAll(void *data, size_t bytes) {
+    char *p = static_cast<char*>(data);
+    while (bytes > 0 && fd >= 0) {
+#ifdef _WIN32
+        const int n = recv(static_cast<socket_t>(fd), p, static_cast<int>(std::min<size_t>(bytes, 1 << 30)), 0);
+#else
+        const ssize_t n = recv(static_cast<socket_t>(fd), p, bytes, 0);
+#endif
+        if (n <= 0) return false;
+        p += n;
+        bytes -= static_cast<size_t>(n);
+    }
+    return fd >= 0;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+// Minimal blocking stream socket for the viewer protocol
+// Endpoints are "tcp:host:port" or "unix:/path/to.sock" (Unix domain sockets are POSIX only).
+class Socket {
+public:
+    Socket() = default;
+    ~Socket();
+    Socket(Socket &&other) noexcept;
+    Socket& operator=(Socket &&other) noexcept;
+    Socket(const Socket&) = delete;
+    Socket& operator=(const Socket&) = delete;
+
+    static Socket listen(const std::string &endpoint);
+    static Socket connect(const std::string &endpoint);
+
+    bool valid() const { return fd >= 0; }
+    Socket accept(int timeout_ms);   // Invalid socket when nobody connected in time
+    bool readable(int timeout_ms);   // Data (or EOF) waiting to be read
+    bool sendAll(const void *data, size_t bytes);
+    bool recvAll(void *data, size_t bytes);
+    void shutdown();  // Unblocks a recv() pending on another thread
+    void close();
+
+    std::string endpoint() const { return bound; }  // With the actual port when listening on port 0
+
+private:
+    long long fd = -1;
+    std::string bound;
+    std::string unix_path;  // Removed again when the listening socket closes
+};
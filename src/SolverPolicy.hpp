@@ -0,0 +1,199 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <execution>
+#include <string>
+#include <vector>
+#include "PinnedPool.hpp"
+
+// Compile-time policies of the solver kernels: storage precision and loop schedule
+// Kernels are written once as templates over <Real, Kernel> and explicitly instantiated
+// for every combination; the config picks one at run time (grid.solver).
+
+// IEEE binary16 storage type; arithmetic happens in fp32 after load()
+struct Half {
+    uint16_t bits = 0;
+
+    Half() = default;
+    explicit Half(float f) : bits(fromFloat(f)) {}
+    explicit operator float() const { return toFloat(bits); }
+
+    // Round to nearest even; overflow saturates to infinity (after F. Giesen's float_to_half_fast3_rtne).
+    // Branchy on purpose: field values are almost always normal or zero, so the branches predict well
+    // and beat both a select-based (vectorizable) version and scalar F16C instructions.
+    static uint16_t fromFloat(float f) {
+        uint32_t u = std::bit_cast<uint32_t>(f);
+        const uint32_t sign = (u >> 16) & 0x8000u;
+        u &= 0x7fffffffu;
+        if (u >= (127u + 16u) << 23) return static_cast<uint16_t>(sign | (u > 0x7f800000u ? 0x7e00u : 0x7c00u));
+        if (u < 113u << 23) {
+            // Subnormal or zero: let the FPU round the mantissa into place
+            const float denorm_magic = std::bit_cast<float>(((127u - 15u) + (23u - 10u) + 1u) << 23);
+            const uint32_t r = std::bit_cast<uint32_t>(std::bit_cast<float>(u) + denorm_magic);
+            return static_cast<uint16_t>(sign | (r - std::bit_cast<uint32_t>(denorm_magic)));
+        }
+        const uint32_t mant_odd = (u >> 13) & 1u;
+        u += (static_cast<uint32_t>(15 - 127) << 23) + 0xfffu + mant_odd;
+        return static_cast<uint16_t>(sign | (u >> 13));
+    }
+
+    static float toFloat(uint16_t h) {
+        const uint32_t shifted_exp = 0x7c00u << 13;
+        uint32_t u = (h & 0x7fffu) << 13;
+        const uint32_t exp = shifted_exp & u;
+        u += (127u - 15u) << 23;
+        if (exp == shifted_exp) {
+            u += (128u - 16u) << 23;  // Inf / NaN
+        } else if (exp == 0) {
+            u += 1u << 23;            // Zero / subnormal: renormalize
+            u = std::bit_cast<uint32_t>(std::bit_cast<float>(u) - std::bit_cast<float>(113u << 23));
+        }
+        return std::bit_cast<float>(u | (static_cast<uint32_t>(h & 0x8000u) << 16));
+    }
+};
+
+namespace precision {
+
+// Acc is the arithmetic type; load/store convert between storage and Acc
+template <typename Real> struct Traits {
+    using Acc = Real;
+    static constexpr const char *name = "float";
+    static Acc load(Real v) { return v; }
+    static Real store(Acc v) { return v; }
+};
+
+template <> struct Traits<double> {
+    using Acc = double;
+    static constexpr const char *name = "double";
+    static double load(double v) { return v; }
+    static double store(double v) { return v; }
+};
+
+template <> struct Traits<Half> {
+    using Acc = float;
+    static constexpr const char *name = "half";
+    static float load(Half v) { return static_cast<float>(v); }
+    static Half store(float v) { return Half(v); }
+};
+
+}
+
+// Loop annotations that make the schedules explicit instead of leaving them to the optimizer:
+// EM2D_SIMD_LOOP vectorizes a lane block (OpenMP simd, enabled with -fopenmp-simd; MSVC drops
+// the dependence checks), EM2D_SCALAR_LOOP keeps the reference loop scalar even at -O3
+#if defined(_MSC_VER) && !defined(__clang__)
+#define EM2D_SIMD_LOOP __pragma(loop(ivdep))
+#define EM2D_SCALAR_LOOP __pragma(loop(no_vector))
+#elif defined(__clang__)
+#define EM2D_SIMD_LOOP _Pragma("omp simd")
+#define EM2D_SCALAR_LOOP _Pragma("clang loop vectorize(disable) interleave(disable)")
+#elif defined(__GNUC__) && __GNUC__ >= 14
+#define EM2D_SIMD_LOOP _Pragma("omp simd")
+#define EM2D_SCALAR_LOOP _Pragma("GCC novector")
+#else
+#define EM2D_SIMD_LOOP _Pragma("omp simd")
+#define EM2D_SCALAR_LOOP
+#endif
+
+namespace kernel {
+
+constexpr int lanes = 16;  // Block width of the vectorized column loops
+
+// Opaque step for compilers without a no-vectorize pragma (GCC before 14): the vectorizer
+// cannot see through the index, so each element stays a scalar iteration
+inline void scalarStep(int &i) {
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ < 14
+    __asm__("" : "+r"(i));
+#else
+    (void)i;
+#endif
+}
+
+// One thread, one element at a time: the reference schedule
+struct Scalar {
+    static constexpr const char *name = "scalar";
+    static constexpr bool blocked = false;
+    template <typename F> static void forRows(const std::vector<int> &rows, int j0, int j1, F &&f) {
+        for (int j = j0; j < j1; ++j) f(rows[j]);
+    }
+};
+
+// One thread, columns in fixed-width blocks the compiler turns into packed SIMD
+struct Simd {
+    static constexpr const char *name = "simd";
+    static constexpr bool blocked = true;
+    template <typename F> static void forRows(const std::vector<int> &rows, int j0, int j1, F &&f) {
+        for (int j = j0; j < j1; ++j) f(rows[j]);
+    }
+};
+
+// Rows spread over the parallel algorithms' thread pool, vectorized columns within each row
+struct Threaded {
+    static constexpr const char *name = "threaded";
+    static constexpr bool blocked = true;
+    template <typename F> static void forRows(const std::vector<int> &rows, int j0, int j1, F &&f) {
+        std::for_each(std::execution::par_unseq, rows.begin() + j0, rows.begin() + j1, f);
+    }
+};
+
+// Rows on the pinned pool: each worker always handles the same row block, so the pages it
+// first-touched (PinnedPool::firstTouch) stay on its socket; vectorized columns within each row
+struct Pinned {
+    static constexpr const char *name = "pinned";
+    static constexpr bool blocked = true;
+    template <typename F> static void forRows(const std::vector<int> &rows, int j0, int j1, F &&f) {
+        PinnedPool::shared().forRows(static_cast<int>(rows.size()), j0, j1, [&](int j) { f(rows[j]); });
+    }
+};
+
+// Column loop [i0, i1): blocked kernels run whole lane blocks as SIMD, then the remainder;
+// the scalar schedule is kept element by element. Columns must be independent.
+template <bool Blocked, typename F>
+inline void forColumns(int i0, int i1, F &&f) {
+    int i = i0;
+    if constexpr (Blocked) {
+        for (; i + lanes <= i1; i += lanes) {
+            EM2D_SIMD_LOOP
+            for (int l = 0; l < lanes; ++l) f(i + l);
+        }
+        for (; i < i1; ++i) f(i);
+    } else {
+        EM2D_SCALAR_LOOP
+        for (; i < i1; ++i) {
+            f(i);
+            scalarStep(i);
+        }
+    }
+}
+
+}
+
+enum class SolverPrecision { Float, Double, Half };
+enum class SolverKernel { Scalar, Simd, Threaded, Pinned };
+
+// Unknown names fall back to the defaults (float / threaded) and return false
+inline bool parseSolverPrecision(const std::string &name, SolverPrecision &out) {
+    if (name == "double") out = SolverPrecision::Double;
+    else if (name == "half" || name == "fp16") out = SolverPrecision::Half;
+    else out = SolverPrecision::Float;
+    return name == "float" || name == "double" || name == "half" || name == "fp16";
+}
+
+inline bool parseSolverKernel(const std::string &name, SolverKernel &out) {
+    if (name == "scalar") out = SolverKernel::Scalar;
+    else if (name == "simd") out = SolverKernel::Simd;
+    else if (name == "pinned") out = SolverKernel::Pinned;
+    else out = SolverKernel::Threaded;
+    return name == "scalar" || name == "simd" || name == "threaded" || name == "pinned";
+}
+
+inline const char* solverPrecisionName(SolverPrecision p) {
+    return p == SolverPrecision::Double ? "double" : p == SolverPrecision::Half ? "half" : "float";
+}
+
+inline const char* solverKernelName(SolverKernel k) {
+    return k == SolverKernel::Scalar ? "scalar" : k == SolverKernel::Simd ? "simd"
+         : k == SolverKernel::Pinned ? "pinned" : "threaded";
+}
@@ -0,0 +1,447 @@
+#include "Stream.hpp"
+#include "Codec.hpp"
+#include "FDTD.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+namespace {
+enum TileEncoding : uint8_t { RawTile = 0, ShuffleRLETile = 1 };
+
+template <typename T>
+void put(std::vector<uint8_t> &buf, T value) {
+    const uint8_t *p = reinterpret_cast<const uint8_t*>(&value);
+    buf.insert(buf.end(), p, p + sizeof(T));
+}
+
+// Bounds-checked reader over a received payload
+struct Reader {
+    const uint8_t *p;
+    size_t left;
+    template <typename T>
+    bool get(T &value) {
+        if (left < sizeof(T)) return false;
+        std::memcpy(&value, p, sizeof(T));
+        p += sizeof(T);
+        left -= sizeof(T);
+        return true;
+    }
+};
+
+inline uint16_t zigzag(int16_t r) {
+    return static_cast<uint16_t>((static_cast<uint16_t>(r) << 1) ^ static_cast<uint16_t>(r >> 15));
+}
+
+inline int16_t unzigzag(uint16_t z) {
+    return static_cast<int16_t>((z >> 1) ^ static_cast<uint16_t>(-static_cast<int>(z & 1)));
+}
+}
+
+namespace stream {
+
+int64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void quantize(const float *field, size_t n, float range, int16_t *q) {
+    const float scale = quant_max / range;
+    for (size_t k = 0; k < n; ++k) {
+        q[k] = static_cast<int16_t>(std::lround(std::clamp(field[k] * scale, -quant_max, quant_max)));
+    }
+}
+
+void encodeFrame(const int16_t *q, const int16_t *ref, int w, int h, int tile, float range,
+                 long long step, uint64_t seq, int64_t sent_ns, std::vector<uint8_t> &msg, size_t *tiles_sent) {
+    msg.clear();
+    msg.insert(msg.end(), {'E', 'M', '2', 'S'});
+    put<uint16_t>(msg, version);
+    put<uint16_t>(msg, frame_message);
+    put<uint32_t>(msg, 0);  // Payload size, patched below
+    put<int64_t>(msg, step);
+    put<uint64_t>(msg, seq);
+    put<int64_t>(msg, sent_ns);
+    put<uint32_t>(msg, static_cast<uint32_t>(w));
+    put<uint32_t>(msg, static_cast<uint32_t>(h));
+    put<uint16_t>(msg, static_cast<uint16_t>(tile));
+    put<uint8_t>(msg, ref ? 0 : 1);
+    put<uint8_t>(msg, 0);
+    put<float>(msg, range);
+    const size_t count_pos = msg.size();
+    put<uint32_t>(msg, 0);
+
+    std::vector<uint16_t> residual;
+    std::vector<uint8_t> shuffled, encoded;
+    residual.reserve(static_cast<size_t>(tile) * tile);
+    uint32_t count = 0;
+    for (int ty = 0; ty * tile < h; ++ty) {
+        for (int tx = 0; tx * tile < w; ++tx) {
+            const int i0 = tx * tile, i1 = std::min(w, i0 + tile);
+            const int j0 = ty * tile, j1 = std::min(h, j0 + tile);
+            residual.clear();
+            bool changed = false;
+            for (int j = j0; j < j1; ++j) {
+                const size_t row = static_cast<size_t>(j) * w;
+                for (int i = i0; i < i1; ++i) {
+                    const int16_t r = static_cast<int16_t>(q[row + i] - (ref ? ref[row + i] : 0));
+                    changed |= r != 0;
+                    residual.push_back(zigzag(r));
+                }
+            }
+            if (!changed) continue;
+
+            const size_t raw = residual.size() * sizeof(uint16_t);
+            codec::shuffle(residual.data(), residual.size(), sizeof(uint16_t), shuffled);
+            codec::rleEncode(shuffled.data(), shuffled.size(), encoded);
+            const bool packed = encoded.size() < raw;
+            put<uint16_t>(msg, static_cast<uint16_t>(tx));
+            put<uint16_t>(msg, static_cast<uint16_t>(ty));
+            put<uint8_t>(msg, packed ? ShuffleRLETile : RawTile);
+            put<uint32_t>(msg, static_cast<uint32_t>(packed ? encoded.size() : raw));
+            const uint8_t *data = packed ? encoded.data() : reinterpret_cast<const uint8_t*>(residual.data());
+            msg.insert(msg.end(), data, data + (packed ? encoded.size() : raw));
+            ++count;
+        }
+    }
+    std::memcpy(&msg[count_pos], &count, sizeof(count));
+    const uint32_t payload = static_cast<uint32_t>(msg.size() - header_bytes);
+    std::memcpy(&msg[8], &payload, sizeof(payload));
+    if (tiles_sent) *tiles_sent = count;
+}
+
+}
+
+bool FrameDecoder::apply(const uint8_t *payload, size_t bytes) {
+    Reader rd{payload, bytes};
+    int64_t step = 0, ns = 0;
+    uint64_t frame_seq = 0;
+    uint32_t fw = 0, fh = 0, count = 0;
+    uint16_t tile = 0;
+    uint8_t keyframe = 0, reserved = 0;
+    float frame_range = 0.0f;
+    if (!rd.get(step) || !rd.get(frame_seq) || !rd.get(ns) || !rd.get(fw) || !rd.get(fh) || !rd.get(tile) ||
+        !rd.get(keyframe) || !rd.get(reserved) || !rd.get(frame_range) || !rd.get(count)) {
+        return false;
+    }
+    if (fw == 0 || fh == 0 || tile == 0 || fw > 65536 || fh > 65536 || !(frame_range > 0.0f)) return false;
+    if (keyframe) {
+        w = static_cast<int>(fw);
+        h = static_cast<int>(fh);
+        range = frame_range;
+        q.assign(static_cast<size_t>(w) * h, 0);
+        values.assign(q.size(), 0.0f);
+        synced = true;
+    } else if (!synced || static_cast<int>(fw) != w || static_cast<int>(fh) != h || frame_range != range) {
+        return false;
+    }
+
+    const float scale = range / stream::quant_max;
+    for (uint32_t t = 0; t < count; ++t) {
+        uint16_t tx = 0, ty = 0;
+        uint8_t encoding = 0;
+        uint32_t size = 0;
+        if (!rd.get(tx) || !rd.get(ty) || !rd.get(encoding) || !rd.get(size) || size > rd.left) return false;
+        const int i0 = tx * tile, i1 = std::min(w, i0 + tile);
+        const int j0 = ty * tile, j1 = std::min(h, j0 + tile);
+        if (i0 >= w || j0 >= h) return false;
+        const size_t n = static_cast<size_t>(i1 - i0) * (j1 - j0);
+        const size_t raw = n * sizeof(uint16_t);
+
+        residual.resize(n);
+        if (encoding == RawTile && size == raw) {
+            std::memcpy(residual.data(), rd.p, raw);
+        } else if (encoding == ShuffleRLETile && codec::rleDecode(rd.p, size, scratch, raw)) {
+            codec::unshuffle(scratch.data(), n, sizeof(uint16_t), residual.data());
+        } else {
+            return false;
+        }
+        rd.p += size;
+        rd.left -= size;
+
+        size_t k = 0;
+        for (int j = j0; j < j1; ++j) {
+            const size_t row = static_cast<size_t>(j) * w;
+            for (int i = i0; i < i1; ++i, ++k) {
+                q[row + i] = static_cast<int16_t>(q[row + i] + unzigzag(residual[k]));
+                values[row + i] = q[row + i] * scale;
+            }
+        }
+    }
+    last_step = step;
+    last_seq = frame_seq;
+    sent_ns = ns;
+    last_tiles = count;
+    return true;
+}
+
+bool receiveMessage(Socket &sock, uint16_t &type, std::vector<uint8_t> &payload) {
+    uint8_t header[stream::header_bytes];
+    if (!sock.recvAll(header, sizeof(header)) || std::memcmp(header, "EM2S", 4) != 0) return false;
+    uint16_t ver = 0;
+    uint32_t bytes = 0;
+    std::memcpy(&ver, header + 4, 2);
+    std::memcpy(&type, header + 6, 2);
+    std::memcpy(&bytes, header + 8, 4);
+    if (ver != stream::version) {
+        std::cerr << "Stream protocol version " << ver << " is not supported (expected " << stream::version << ")\n";
+        return false;
+    }
+    payload.resize(bytes);
+    return sock.recvAll(payload.data(), bytes);
+}
+
+StreamServer::StreamServer(const StreamConfig &conf_) : conf(conf_) {
+    if (!conf.enabled) return;
+    conf.tile = std::clamp(conf.tile, 8, 1024);
+    conf.interval = std::max(conf.interval, 1);
+    listener = Socket::listen(conf.endpoint);
+    if (!listener.valid()) {
+        std::cout << "Field streaming disabled" << std::endl;
+        return;
+    }
+    std::cout << "Streaming field frames on " << listener.endpoint() << " (" << conf.tile << "x" << conf.tile
+              << " tiles, view with: em2d --view " << listener.endpoint() << ")" << std::endl;
+    sender = std::thread([this] { senderLoop(); });
+}
+
+StreamServer::~StreamServer() {
+    stop();
+}
+
+void StreamServer::publish(const FDTD &sim, float color_range) {
+    if (!enabled() || ++frame_counter % conf.interval != 0) return;
+    const float range = conf.range > 0.0 ? static_cast<float>(conf.range) : 2.0f * color_range;
+    // Unchanged fields only need resending when the quantization range moved
+    if (sim.fieldVersion() == published_version && range == published_range) return;
+    published_version = sim.fieldVersion();
+    published_range = range;
+    publish(sim.getEz(), sim.displayWidth(), sim.displayHeight(), sim.getStep(), range);
+}
+
+void StreamServer::publish(const std::vector<float> &field, int w, int h, long long step, float range) {
+    if (!enabled()) return;
+    {
+        std::lock_guard<std::mutex> lock(m);
+        if (has_pending) ++frames_skipped;  // The sender is behind: replace its pending frame
+        pending.field.assign(field.begin(), field.end());
+        pending.w = w;
+        pending.h = h;
+        pending.step = step;
+        pending.range = range;
+        pending.sent_ns = stream::nowNs();
+        has_pending = true;
+    }
+    cv.notify_one();
+}
+
+size_t StreamServer::broadcast(const std::vector<uint8_t> &msg, bool keyframes_only) {
+    size_t bytes = 0;
+    for (auto &c : clients) {
+        if (c.synced == keyframes_only) continue;
+        if (!c.sock.sendAll(msg.data(), msg.size())) {
+            c.sock.close();
+            continue;
+        }
+        c.synced = true;
+        bytes += msg.size();
+    }
+    clients.erase(std::remove_if(clients.begin(), clients.end(), [](const Client &c) { return !c.sock.valid(); }),
+                  clients.end());
+    return bytes;
+}
+
+void StreamServer::senderLoop() {
+    std::vector<uint8_t> msg;
+    while (true) {
+        for (Socket s = listener.accept(0); s.valid(); s = listener.accept(0)) {
+            clients.push_back({std::move(s), false});
+            std::lock_guard<std::mutex> lock(m);
+            peak_clients = std::max(peak_clients, clients.size());
+        }
+
+        bool have_frame = false;
+        {
+            std::unique_lock<std::mutex> lock(m);
+            cv.wait_for(lock, std::chrono::milliseconds(20), [this] { return has_pending || quit; });
+            if (quit) return;
+            if (has_pending) {
+                std::swap(pending, working);
+                has_pending = false;
+                have_frame = true;
+            }
+        }
+
+        if (have_frame) {
+            auto start = std::chrono::steady_clock::now();
+            const size_t n = static_cast<size_t>(working.w) * working.h;
+            q.resize(n);
+            stream::quantize(working.field.data(), n, working.range, q.data());
+            // New geometry or quantization range invalidates every client's reference frame
+            if (working.w != last_w || working.h != last_h || working.range != last_range) {
+                for (auto &c : clients) c.synced = false;
+                last.clear();
+            }
+            ++seq;
+            size_t tiles = 0;
+            const bool any_synced = std::any_of(clients.begin(), clients.end(), [](const Client &c) { return c.synced; });
+            if (any_synced && !last.empty()) {
+                stream::encodeFrame(q.data(), last.data(), working.w, working.h, conf.tile, working.range,
+                                    working.step, seq, working.sent_ns, msg, &tiles);
+                const double enc = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                auto send_start = std::chrono::steady_clock::now();
+                const size_t bytes = broadcast(msg, false);
+                std::lock_guard<std::mutex> lock(m);
+                bytes_sent += bytes;
+                encode_s += enc;
+                send_s += std::chrono::duration<double>(std::chrono::steady_clock::now() - send_start).count();
+                ++frames_sent;
+                raw_bytes += n * sizeof(float);
+                tiles_sent += tiles;
+                tiles_total += static_cast<size_t>((working.w + conf.tile - 1) / conf.tile) *
+                               ((working.h + conf.tile - 1) / conf.tile);
+            }
+            std::swap(q, last);
+            last_w = working.w;
+            last_h = working.h;
+            last_range = working.range;
+            last_step = working.step;
+            last_sent_ns = working.sent_ns;
+        }
+
+        // Newcomers (and clients whose reference frame was invalidated) get the latest frame as a keyframe
+        const bool any_new = std::any_of(clients.begin(), clients.end(), [](const Client &c) { return !c.synced; });
+        if (any_new && !last.empty()) {
+            stream::encodeFrame(last.data(), nullptr, last_w, last_h, conf.tile, last_range,
+                                last_step, seq, last_sent_ns, msg);
+            const size_t bytes = broadcast(msg, true);
+            std::lock_guard<std::mutex> lock(m);
+            ++keyframes_sent;
+            keyframe_bytes += bytes;
+        }
+    }
+}
+
+void StreamServer::stop() {
+    if (!sender.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(m);
+        quit = true;
+    }
+    cv.notify_all();
+    sender.join();
+    clients.clear();
+    listener.close();
+
+    std::cout << "?? Stream: " << frames_sent << " delta frames and " << keyframes_sent << " keyframes ("
+              << (keyframe_bytes >> 10) << " KB) sent, " << frames_skipped
+              << " superseded before sending, peak " << peak_clients << " viewers" << std::endl;
+    if (frames_sent > 0) {
+        const double kb = bytes_sent / 1024.0 / frames_sent;
+        std::cout << "   " << std::fixed << std::setprecision(1) << kb << " KB/frame ("
+                  << (raw_bytes / 1024.0 / frames_sent) << " KB as float32, "
+                  << (100.0 * tiles_sent / std::max<size_t>(tiles_total, 1)) << "% tiles changed), encode "
+                  << (1000.0 * encode_s / frames_sent) << "ms, send " << (1000.0 * send_s / frames_sent)
+                  << "ms per frame" << std::defaultfloat << std::setprecision(6) << std::endl;
+    }
+}
+
+namespace {
+bool selfTestTransport(const Config &cfg, const std::string &endpoint) {
+    StreamConfig sc = cfg.stream;
+    sc.enabled = true;
+    sc.endpoint = endpoint;
+    sc.interval = 1;
+    StreamServer server(sc);
+    if (!server.enabled()) return false;
+    Socket client = Socket::connect(server.endpoint());
+    if (!client.valid()) {
+        std::cerr << "Self-test client could not connect to " << server.endpoint() << "\n";
+        return false;
+    }
+
+    FDTD sim(cfg.grid);
+    for (const auto &m : cfg.materials) sim.addMaterialBlock(m.x0, m.y0, m.w, m.h, m.eps_r);
+    for (const auto &s : cfg.sources) sim.addSource(s);
+    for (const auto &m : cfg.magnets) sim.addMagnet(m);
+    sim.step();
+
+    const float color_range = static_cast<float>(cfg.vis.color_range);
+    const float range = sc.range > 0.0 ? static_cast<float>(sc.range) : 2.0f * color_range;
+    FrameDecoder decoder;
+    std::vector<uint8_t> payload;
+    std::vector<int16_t> expected_q;
+    const int frames = sim.isTimeDomain() ? 60 : 3;
+    size_t bytes = 0, tiles = 0;
+    double latency_sum = 0.0, latency_max = 0.0;
+    bool ok = true;
+    for (int f = 0; f < frames && ok; ++f) {
+        if (f > 0 && sim.isTimeDomain()) sim.advance(cfg.steps_per_frame);
+        server.publish(sim, color_range);
+        // Frames of an unchanged static field are not re-sent
+        if (f > 0 && !sim.isTimeDomain()) continue;
+
+        uint16_t type = 0;
+        if (!receiveMessage(client, type, payload) || type != stream::frame_message || !decoder.apply(payload.data(), payload.size())) {
+            std::cerr << "Self-test: frame " << f << " was not received or did not decode\n";
+            ok = false;
+            break;
+        }
+        const double latency_ms = (stream::nowNs() - decoder.sentNs()) / 1e6;
+        latency_sum += latency_ms;
+        latency_max = std::max(latency_max, latency_ms);
+        bytes += payload.size() + stream::header_bytes;
+        tiles += decoder.tiles();
+
+        // The client must hold exactly the quantized solver field
+        const std::vector<float> &ez = sim.getEz();
+        expected_q.resize(ez.size());
+        stream::quantize(ez.data(), ez.size(), range, expected_q.data());
+        const float scale = range / stream::quant_max;
+        const std::vector<float> &got = decoder.field();
+        if (decoder.width() != sim.displayWidth() || decoder.height() != sim.displayHeight() || got.size() != ez.size()) {
+            std::cerr << "Self-test: frame size mismatch\n";
+            ok = false;
+            break;
+        }
+        for (size_t k = 0; k < ez.size(); ++k) {
+            if (got[k] != expected_q[k] * scale) {
+                std::cerr << "Self-test: value mismatch at cell " << k << " of frame " << f << "\n";
+                ok = false;
+                break;
+            }
+        }
+    }
+    const int received = sim.isTimeDomain() ? frames : 1;
+    server.stop();
+    if (ok) {
+        std::cout << "   " << endpoint << ": " << received << " frames verified, " << std::fixed << std::setprecision(1)
+                  << (bytes / 1024.0 / received) << " KB/frame, " << (static_cast<double>(tiles) / received)
+                  << " tiles/frame, latency avg " << std::setprecision(2) << (latency_sum / received) << "ms max "
+                  << latency_max << "ms" << std::defaultfloat << std::setprecision(6) << std::endl;
+    }
+    return ok;
+}
+}
+
+int runStreamSelfTest(const std::string &config_path) {
+    auto cfg = Config::loadFromFile(config_path);
+    if (!cfg) return 1;
+    cfg->grid.decomposition.ranks = 1;
+    std::cout << "Stream self-test on scenario " << cfg->scenario << " (" << cfg->grid.nx << "x" << cfg->grid.ny << ")" << std::endl;
+
+    std::vector<std::string> endpoints = {"tcp:127.0.0.1:0"};
+#ifndef _WIN32
+    endpoints.push_back("unix:/tmp/em2d_selftest_" + std::to_string(getpid()) + ".sock");
+#endif
+    bool ok = true;
+    for (const auto &e : endpoints) ok = selfTestTransport(*cfg, e) && ok;
+    std::cout << (ok ? "? Stream self-test passed" : "? Stream self-test FAILED") << std::endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Config.hpp"
+#include "Socket.hpp"
+
+class FDTD;
+
+// Viewer stream protocol, version 1 (native little-endian)
+// Every message: "EM2S" | u16 version | u16 type | u32 payload bytes | payload
+// Frame payload: i64 step | u64 seq | i64 sent_ns | u32 w | u32 h | u16 tile | u8 keyframe | u8 reserved
+//                | f32 range | u32 tiles, then per changed tile:
+//                u16 tx | u16 ty | u8 encoding | u32 bytes | payload
+// Field values are quantized to int16 over [-range, range]. A tile payload holds the
+// zigzagged residual against the previous frame (against zero in keyframes), either
+// raw (encoding 0) or byte-shuffled and run-length encoded (encoding 1).
+namespace stream {
+constexpr uint16_t version = 1;
+constexpr uint16_t frame_message = 1;
+constexpr size_t header_bytes = 12;
+constexpr float quant_max = 32767.0f;
+
+int64_t nowNs();  // Steady clock; comparable between processes on the same host
+void quantize(const float *field, size_t n, float range, int16_t *q);
+
+// Encodes q as a complete frame message; ref == nullptr makes a keyframe
+void encodeFrame(const int16_t *q, const int16_t *ref, int w, int h, int tile, float range,
+                 long long step, uint64_t seq, int64_t sent_ns, std::vector<uint8_t> &msg, size_t *tiles_sent = nullptr);
+}
+
+// Client-side frame state: applies frame payloads and keeps the dequantized field
+class FrameDecoder {
+public:
+    bool apply(const uint8_t *payload, size_t bytes);  // false on malformed data or a delta without a keyframe
+    const std::vector<float>& field() const { return values; }
+    int width() const { return w; }
+    int height() const { return h; }
+    long long step() const { return last_step; }
+    uint64_t seq() const { return last_seq; }
+    int64_t sentNs() const { return sent_ns; }
+    size_t tiles() const { return last_tiles; }
+    float quantRange() const { return range; }
+
+private:
+    int w = 0, h = 0;
+    float range = 1.0f;
+    bool synced = false;
+    long long last_step = 0;
+    uint64_t last_seq = 0;
+    int64_t sent_ns = 0;
+    size_t last_tiles = 0;
+    std::vector<int16_t> q;
+    std::vector<float> values;
+    std::vector<uint8_t> scratch;
+    std::vector<uint16_t> residual;
+};
+
+// Receives one message; false when the connection closed or sent garbage
+bool receiveMessage(Socket &sock, uint16_t &type, std::vector<uint8_t> &payload);
+
+// Publishes solver frames to any number of viewers
+// publish() hands a copy of the field to the sender thread and returns; if the
+// previous frame has not been sent yet it is replaced (and counted as skipped),
+// so slow viewers never hold up the solver. Clients joining late get a keyframe.
+class StreamServer {
+public:
+    explicit StreamServer(const StreamConfig &conf);
+    ~StreamServer();
+    StreamServer(const StreamServer&) = delete;
+    StreamServer& operator=(const StreamServer&) = delete;
+
+    bool enabled() const { return listener.valid(); }
+    std::string endpoint() const { return listener.endpoint(); }
+    void publish(const FDTD &sim, float color_range);
+    void publish(const std::vector<float> &field, int w, int h, long long step, float range);
+    void stop();  // Joins the sender thread and prints bandwidth statistics
+
+private:
+    struct Client {
+        Socket sock;
+        bool synced = false;
+    };
+    struct Pending {
+        std::vector<float> field;
+        int w = 0, h = 0;
+        long long step = 0;
+        float range = 1.0f;
+        int64_t sent_ns = 0;
+    };
+
+    StreamConfig conf;
+    Socket listener;
+    std::thread sender;
+    std::mutex m;
+    std::condition_variable cv;
+    Pending pending, working;
+    bool has_pending = false;
+    bool quit = false;
+    unsigned long long published_version = ~0ull;
+    float published_range = 0.0f;
+    int frame_counter = 0;
+
+    // Sender thread state
+    std::vector<Client> clients;
+    std::vector<int16_t> q, last;
+    int last_w = 0, last_h = 0;
+    float last_range = 0.0f;
+    uint64_t seq = 0;
+    long long last_step = 0;
+    int64_t last_sent_ns = 0;
+
+    // Statistics (guarded by m)
+    size_t frames_sent = 0, frames_skipped = 0, bytes_sent = 0, raw_bytes = 0, tiles_sent = 0, tiles_total = 0;
+    size_t keyframes_sent = 0, keyframe_bytes = 0, peak_clients = 0;
+    double encode_s = 0.0, send_s = 0.0;
+
+    void senderLoop();
+    size_t broadcast(const std::vector<uint8_t> &msg, bool keyframes_only);  // Bytes actually sent
+};
+
+// em2d --stream-selftest [config]: solver, server and decoding client on localhost (TCP and Unix socket)
+int runStreamSelfTest(const std::string &config_path);
@@ -0,0 +1,284 @@
+#include "Sweep.hpp"
+#include "Dipole.hpp"
+#include "FDTD.hpp"
+#include "WorkStealingPool.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <execution>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+
+namespace {
+// "magnets[2].strength" -> ("magnets", 2, "strength")
+bool parseTarget(const std::string &target, std::string &list, size_t &index, std::string &field) {
+    const size_t open = target.find('[');
+    const size_t close = target.find(']', open);
+    if (open == std::string::npos || close == std::string::npos || close + 1 >= target.size() ||
+        target[close + 1] != '.' || close == open + 1) {
+        return false;
+    }
+    const std::string digits = target.substr(open + 1, close - open - 1);
+    if (!std::all_of(digits.begin(), digits.end(), [](char c) { return c >= '0' && c <= '9'; })) return false;
+    list = target.substr(0, open);
+    index = std::strtoul(digits.c_str(), nullptr, 10);
+    field = target.substr(close + 2);
+    return true;
+}
+
+void fieldStatistics(const float *f, size_t n, SweepResult &r) {
+    auto minmax = std::minmax_element(f, f + n);
+    r.field_min = *minmax.first;
+    r.field_max = *minmax.second;
+    double sum = 0.0;
+    size_t active = 0;
+    for (size_t k = 0; k < n; ++k) {
+        sum += std::abs(f[k]);
+        active += std::abs(f[k]) > 0.01f;
+    }
+    r.mean_abs = sum / n;
+    r.active_fraction = static_cast<double>(active) / n;
+}
+}
+
+bool applySweepParameter(Config &cfg, const std::string &target, double value) {
+    std::string list, field;
+    size_t k = 0;
+    if (!parseTarget(target, list, k, field)) return false;
+    const int iv = static_cast<int>(std::lround(value));
+
+    if (list == "magnets" && k < cfg.magnets.size()) {
+        MagnetConfig &m = cfg.magnets[k];
+        if (field == "x") m.x = iv;
+        else if (field == "y") m.y = iv;
+        else if (field == "moment_x") m.moment_x = value;
+        else if (field == "moment_y") m.moment_y = value;
+        else if (field == "strength") m.strength = value;
+        else return false;
+        return true;
+    }
+    if (list == "materials" && k < cfg.materials.size()) {
+        MaterialBlock &m = cfg.materials[k];
+        if (field == "x0") m.x0 = iv;
+        else if (field == "y0") m.y0 = iv;
+        else if (field == "w") m.w = iv;
+        else if (field == "h") m.h = iv;
+        else if (field == "eps_r") m.eps_r = value;
+        else return false;
+        return true;
+    }
+    if (list == "sources" && k < cfg.sources.size()) {
+        SourceConfig &s = cfg.sources[k];
+        if (field == "x") s.x = iv;
+        else if (field == "y") s.y = iv;
+        else if (field == "amplitude") s.amplitude = value;
+        else if (field == "t0") s.t0 = value;
+        else if (field == "spread") s.spread = value;
+        else if (field == "freq_hz") s.freq_hz = value;
+        else return false;
+        return true;
+    }
+    return false;
+}
+
+SweepRunner::SweepRunner(const Config &base_, const SweepConfig &sweep_)
+: base(base_), sweep(sweep_) {
+    time_domain = !base.sources.empty();
+
+    // Variants run on plain in-process uniform grids
+    if (base.grid.adaptive.enabled || base.grid.out_of_core.enabled || base.grid.decomposition.ranks > 1) {
+        std::cout << "Sweep: adaptive, out-of-core and decomposed modes are disabled for variants" << std::endl;
+        base.grid.adaptive.enabled = false;
+        base.grid.out_of_core.enabled = false;
+        base.grid.decomposition.ranks = 1;
+    }
+
+    for (const auto &p : sweep.parameters) {
+        Config probe = base;
+        if (p.values.empty() || !applySweepParameter(probe, p.target, p.values.front())) {
+            std::cerr << "Sweep: invalid parameter '" << p.target << "' (unknown target, index or empty values)\n";
+            ok = false;
+            continue;
+        }
+        variant_count *= p.values.size();
+
+        std::string list, field;
+        size_t k = 0;
+        parseTarget(p.target, list, k, field);
+        if (list == "magnets" && std::find(swept_magnets.begin(), swept_magnets.end(), static_cast<int>(k)) == swept_magnets.end()) {
+            swept_magnets.push_back(static_cast<int>(k));
+        }
+    }
+    if (!ok) return;
+
+    std::cout << "Sweep: " << sweep.parameters.size() << " parameters, " << variant_count << " variants ("
+              << (time_domain ? "time-domain, " + std::to_string(base.max_steps) + " steps each" : "static magnet field")
+              << ")" << std::endl;
+    if (time_domain) return;
+    if (base.magnets.empty()) std::cout << "Sweep: base config has no magnets - static fields will be zero" << std::endl;
+
+    // Shared read-only partial field of every magnet the sweep leaves alone
+    const int nx = base.grid.nx, ny = base.grid.ny;
+    std::vector<dipole::Pole<float>> fixed;
+    for (size_t k = 0; k < base.magnets.size(); ++k) {
+        if (std::find(swept_magnets.begin(), swept_magnets.end(), static_cast<int>(k)) == swept_magnets.end()) {
+            fixed.push_back(dipole::pole<float>(base.magnets[k]));
+        }
+    }
+    auto start = std::chrono::high_resolution_clock::now();
+    partial.assign(static_cast<size_t>(nx) * ny, 0.0f);
+    std::vector<int> rows(ny);
+    std::iota(rows.begin(), rows.end(), 0);
+    std::for_each(std::execution::par_unseq, rows.begin(), rows.end(), [&](int j) {
+        float *dst = &partial[static_cast<size_t>(j) * nx];
+        for (int i = 0; i < nx; ++i) {
+            float sum = 0.0f;
+            for (const auto &m : fixed) {
+                sum += dipole::contribution<float>(static_cast<float>(i - m.x), static_cast<float>(j - m.y), m);
+            }
+            dst[i] = sum;
+        }
+    });
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    std::cout << "Sweep: shared partial field of " << fixed.size() << " fixed magnets computed in " << ms
+              << "ms; each variant evaluates " << swept_magnets.size() << " swept magnets" << std::endl;
+}
+
+SweepRunner::~SweepRunner() = default;
+
+Config SweepRunner::variant(size_t index, std::vector<double> &values) const {
+    // Mixed-radix decomposition of the variant index, last parameter varying fastest
+    Config cfg = base;
+    values.assign(sweep.parameters.size(), 0.0);
+    for (size_t p = sweep.parameters.size(); p-- > 0;) {
+        const auto &param = sweep.parameters[p];
+        values[p] = param.values[index % param.values.size()];
+        index /= param.values.size();
+        applySweepParameter(cfg, param.target, values[p]);
+    }
+    return cfg;
+}
+
+void SweepRunner::runStatic(const Config &cfg, SweepResult &result) {
+    const int nx = cfg.grid.nx, ny = cfg.grid.ny;
+    auto buffer = buffers.acquire();
+    if (!buffer) buffer = std::make_unique<std::vector<float>>(partial.size());
+    float *f = buffer->data();
+    std::copy(partial.begin(), partial.end(), f);
+
+    for (int k : swept_magnets) {
+        const auto m = dipole::pole<float>(cfg.magnets[k]);
+        for (int j = 0; j < ny; ++j) {
+            float *row = f + static_cast<size_t>(j) * nx;
+            const float dy_val = static_cast<float>(j - m.y);
+            for (int i = 0; i < nx; ++i) row[i] += dipole::contribution<float>(static_cast<float>(i - m.x), dy_val, m);
+        }
+    }
+    for (size_t n = 0; n < partial.size(); ++n) {
+        f[n] = std::clamp(f[n], dipole::field_clamp_min, dipole::field_clamp_max);
+    }
+    fieldStatistics(f, partial.size(), result);
+    buffers.release(std::move(buffer));
+}
+
+void SweepRunner::runTimeDomain(const Config &cfg, SweepResult &result) {
+    auto sim = solvers.acquire();
+    if (sim) sim->clearScene();
+    else sim = std::make_unique<FDTD>(cfg.grid);
+
+    for (const auto &m : cfg.materials) sim->addMaterialBlock(m.x0, m.y0, m.w, m.h, m.eps_r);
+    for (const auto &s : cfg.sources) sim->addSource(s);
+    for (const auto &m : cfg.magnets) sim->addMagnet(m);
+    sim->advance(cfg.max_steps);
+
+    const std::vector<float> &ez = sim->getEz();
+    fieldStatistics(ez.data(), ez.size(), result);
+    solvers.release(std::move(sim));
+}
+
+std::vector<SweepResult> SweepRunner::run() {
+    std::vector<SweepResult> results(variant_count);
+    WorkStealingPool pool(sweep.threads);
+    std::cout << "Sweep: running on " << pool.size() << " worker threads" << std::endl;
+
+    for (size_t v = 0; v < variant_count; ++v) {
+        pool.submit([this, v, &results] {
+            auto start = std::chrono::high_resolution_clock::now();
+            SweepResult &r = results[v];
+            const Config cfg = variant(v, r.values);
+            if (time_domain) runTimeDomain(cfg, r);
+            else runStatic(cfg, r);
+            r.ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+        });
+    }
+    pool.wait();
+    steals = pool.steals();
+    return results;
+}
+
+void SweepRunner::printSummary(const std::vector<SweepResult> &results, double seconds) const {
+    std::cout << "\n?? Sweep Summary (" << results.size() << " variants)" << std::endl;
+    std::cout << "   " << std::setw(6) << "#";
+    for (const auto &p : sweep.parameters) std::cout << std::setw(22) << p.target;
+    std::cout << std::setw(10) << "min" << std::setw(10) << "max" << std::setw(12) << "mean|F|"
+              << std::setw(10) << "active%" << std::setw(10) << "ms" << std::endl;
+
+    size_t best = 0;
+    for (size_t v = 0; v < results.size(); ++v) {
+        const SweepResult &r = results[v];
+        std::cout << "   " << std::setw(6) << v;
+        for (double value : r.values) std::cout << std::setw(22) << value;
+        std::cout << std::fixed << std::setprecision(3) << std::setw(10) << r.field_min << std::setw(10) << r.field_max
+                  << std::setprecision(5) << std::setw(12) << r.mean_abs << std::setprecision(2)
+                  << std::setw(10) << (100.0 * r.active_fraction) << std::setw(10) << r.ms
+                  << std::defaultfloat << std::setprecision(6) << std::endl;
+        if (r.mean_abs > results[best].mean_abs) best = v;
+    }
+
+    std::cout << "   Strongest mean field: variant " << best << std::endl;
+    std::cout << "?? Throughput: " << std::fixed << std::setprecision(2) << (results.size() / seconds)
+              << " scenarios/s (" << seconds << " s total), " << steals << " tasks stolen" << std::defaultfloat << std::setprecision(6) << std::endl;
+    std::cout << "   Buffers allocated: " << buffers.created() << ", reused: " << buffers.reused()
+              << " | solvers allocated: " << solvers.created() << ", reused: " << solvers.reused() << std::endl;
+}
+
+bool SweepRunner::writeCsv(const std::string &path, const std::vector<SweepResult> &results) const {
+    std::ofstream ofs(path);
+    if (!ofs) {
+        std::cerr << "Could not write sweep results to " << path << "\n";
+        return false;
+    }
+    ofs << "variant";
+    for (const auto &p : sweep.parameters) ofs << "," << p.target;
+    ofs << ",field_min,field_max,mean_abs,active_fraction,ms\n";
+    for (size_t v = 0; v < results.size(); ++v) {
+        const SweepResult &r = results[v];
+        ofs << v;
+        for (double value : r.values) ofs << "," << value;
+        ofs << "," << r.field_min << "," << r.field_max << "," << r.mean_abs << "," << r.active_fraction << "," << r.ms << "\n";
+    }
+    std::cout << "Sweep results written to " << path << std::endl;
+    return true;
+}
+
+int runSweep(const std::string &sweep_path) {
+    auto sweep = SweepConfig::loadFromFile(sweep_path);
+    if (!sweep) return 1;
+    auto base = Config::loadFromFile(sweep->base);
+    if (!base) return 1;
+
+    std::cout << "Parameter sweep over base scenario: " << base->scenario << std::endl;
+    SweepRunner runner(*base, *sweep);
+    if (!runner.valid()) return 1;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    const std::vector<SweepResult> results = runner.run();
+    const double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+    runner.printSummary(results, seconds);
+    if (!sweep->output.empty()) runner.writeCsv(sweep->output, results);
+    return 0;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Config.hpp"
+#include "ResourcePool.hpp"
+
+class FDTD;
+
+struct SweepResult {
+    std::vector<double> values;  // One per sweep parameter
+    float field_min = 0.0f;
+    float field_max = 0.0f;
+    double mean_abs = 0.0;
+    double active_fraction = 0.0;  // |field| > 0.01, as in the solver statistics
+    double ms = 0.0;
+};
+
+// Runs every variant of a parameter sweep on a work-stealing pool
+// Magnets no parameter touches are summed once into a shared, unclamped partial field;
+// a static variant copies it into a pooled buffer and adds only its swept magnets.
+// Base configs with sources run each variant in the time domain on pooled FDTD instances.
+class SweepRunner {
+public:
+    SweepRunner(const Config &base, const SweepConfig &sweep);
+    ~SweepRunner();
+
+    bool valid() const { return ok; }
+    size_t variantCount() const { return variant_count; }
+    std::vector<SweepResult> run();
+    void printSummary(const std::vector<SweepResult> &results, double seconds) const;
+    bool writeCsv(const std::string &path, const std::vector<SweepResult> &results) const;
+
+private:
+    Config base;
+    SweepConfig sweep;
+    size_t variant_count = 1;
+    bool time_domain = false;
+    bool ok = true;
+    size_t steals = 0;
+
+    std::vector<int> swept_magnets;   // Magnet indices touched by any parameter
+    std::vector<float> partial;       // Shared unclamped field of the untouched magnets
+    ResourcePool<std::vector<float>> buffers;
+    ResourcePool<FDTD> solvers;
+
+    Config variant(size_t index, std::vector<double> &values) const;
+    void runStatic(const Config &cfg, SweepResult &result);
+    void runTimeDomain(const Config &cfg, SweepResult &result);
+};
+
+// Sets e.g. "magnets[1].x" or "materials[0].eps_r"; false for unknown targets or indices
+bool applySweepParameter(Config &cfg, const std::string &target, double value);
+
+// Entry point of `em2d --sweep sweep.json`; returns the process exit code
+int runSweep(const std::string &sweep_path);
@@ -0,0 +1,137 @@
+#include "TiledField.hpp"
+#include <cstdint>
+#include <cstring>
+#include <numeric>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+TiledField::~TiledField() {
+    close();
+}
+
+bool TiledField::open(const std::string &path, int nx_, int ny_, int tile, size_t resident_limit) {
+    close();
+    nx = nx_;
+    ny = ny_;
+    tile_n = std::max(tile, 16);
+    tiles_x = (nx + tile_n - 1) / tile_n;
+    tiles_y = (ny + tile_n - 1) / tile_n;
+    const size_t bytes = static_cast<size_t>(tiles_x) * tiles_y * tile_n * tile_n * sizeof(float);
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        std::cerr << "Could not create field file " << path << " (error " << GetLastError() << ")\n";
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE, static_cast<DWORD>(bytes >> 32),
+                                        static_cast<DWORD>(bytes & 0xffffffffu), nullptr);
+    void *view = mapping ? MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, bytes) : nullptr;
+    if (!view) {
+        std::cerr << "Could not map " << (bytes >> 20) << " MB field file " << path << " (error " << GetLastError() << ")\n";
+        if (mapping) CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+    file_handle = file;
+    mapping_handle = mapping;
+#else
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        std::cerr << "Could not create field file " << path << ": " << std::strerror(errno) << "\n";
+        return false;
+    }
+    // Reserve the blocks up front so a full disk fails here rather than as SIGBUS mid-run
+    int err = 0;
+#if defined(__linux__)
+    err = posix_fallocate(fd, 0, static_cast<off_t>(bytes));
+    if (err == EOPNOTSUPP || err == EINVAL) err = ftruncate(fd, static_cast<off_t>(bytes)) == 0 ? 0 : errno;
+#else
+    err = ftruncate(fd, static_cast<off_t>(bytes)) == 0 ? 0 : errno;
+#endif
+    void *view = err == 0 ? mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+    if (view == MAP_FAILED) {
+        std::cerr << "Could not map " << (bytes >> 20) << " MB field file " << path << ": "
+                  << std::strerror(err ? err : errno) << "\n";
+        ::close(fd);
+        fd = -1;
+        return false;
+    }
+#endif
+
+    data = static_cast<float*>(view);
+    mapped_bytes = bytes;
+    drop_behind = bytes > resident_limit;
+    std::cout << "Tiled field " << path << ": " << tiles_x << "x" << tiles_y << " tiles of " << tile_n << "x" << tile_n
+              << ", " << (bytes >> 20) << " MB mapped" << (drop_behind ? " (streaming)" : "") << std::endl;
+    return true;
+}
+
+void TiledField::close() {
+    if (!data) return;
+#ifdef _WIN32
+    UnmapViewOfFile(data);
+    CloseHandle(static_cast<HANDLE>(mapping_handle));
+    CloseHandle(static_cast<HANDLE>(file_handle));
+    mapping_handle = file_handle = nullptr;
+#else
+    munmap(data, mapped_bytes);
+    ::close(fd);
+    fd = -1;
+#endif
+    data = nullptr;
+    mapped_bytes = 0;
+}
+
+void TiledField::prefetchRow(int ty) const {
+    if (!data || ty < 0 || ty >= tiles_y) return;
+    char *begin = reinterpret_cast<char*>(data) + ty * rowBytes();
+#ifdef _WIN32
+    WIN32_MEMORY_RANGE_ENTRY range{begin, rowBytes()};
+    PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+#else
+    // madvise needs a page-aligned start
+    const uintptr_t page = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+    char *aligned = reinterpret_cast<char*>(reinterpret_cast<uintptr_t>(begin) & ~(page - 1));
+    madvise(aligned, rowBytes() + (begin - aligned), MADV_WILLNEED);
+#endif
+}
+
+void TiledField::releaseRow(int ty) const {
+    if (!data || !drop_behind || ty < 0 || ty >= tiles_y) return;
+    char *begin = reinterpret_cast<char*>(data) + ty * rowBytes();
+#ifdef _WIN32
+    FlushViewOfFile(begin, rowBytes());
+    VirtualUnlock(begin, rowBytes()); // Unlocking unlocked pages trims them from the working set
+#else
+    const uintptr_t page = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+    char *aligned = reinterpret_cast<char*>(reinterpret_cast<uintptr_t>(begin) & ~(page - 1));
+    const size_t len = rowBytes() + (begin - aligned);
+    msync(aligned, len, MS_ASYNC);
+    madvise(aligned, len, MADV_DONTNEED); // Shared file pages: dirty data stays in the page cache
+#endif
+}
+
+void TiledField::downsample(std::vector<float> &out, int w, int h) const {
+    out.assign(static_cast<size_t>(w) * h, 0.0f);
+    if (!data) return;
+    std::vector<int> cols(w), rows_(h), out_rows(h);
+    for (int I = 0; I < w; ++I) cols[I] = std::min(nx - 1, static_cast<int>((I + 0.5) * nx / w));
+    for (int J = 0; J < h; ++J) rows_[J] = std::min(ny - 1, static_cast<int>((J + 0.5) * ny / h));
+    std::iota(out_rows.begin(), out_rows.end(), 0);
+    std::for_each(std::execution::par, out_rows.begin(), out_rows.end(), [&](int J) {
+        const int j = rows_[J];
+        float *dst = &out[static_cast<size_t>(J) * w];
+        for (int I = 0; I < w; ++I) dst[I] = at(cols[I], j);
+    });
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <execution>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <vector>
+
+// Out-of-core 2-D float field stored as square tiles in a memory-mapped file
+// Tiles are laid out one row of tiles after another, each tile row-major, so walking
+// the domain in tile-row order is sequential file I/O. Kernels write straight into
+// the mapping; the next tile row is prefetched while the current one is computed,
+// and finished rows are written back and dropped once the file exceeds the resident limit.
+class TiledField {
+public:
+    TiledField() = default;
+    ~TiledField();
+    TiledField(const TiledField&) = delete;
+    TiledField& operator=(const TiledField&) = delete;
+
+    // Creates (or truncates) the backing file and maps it; logs the reason and returns false on failure
+    bool open(const std::string &path, int nx, int ny, int tile, size_t resident_limit);
+    void close();
+    bool isOpen() const { return data != nullptr; }
+
+    int width() const { return nx; }
+    int height() const { return ny; }
+    int tileSize() const { return tile_n; }
+    int tilesX() const { return tiles_x; }
+    int tilesY() const { return tiles_y; }
+    size_t bytes() const { return mapped_bytes; }
+
+    float* tile(int tx, int ty) { return data + (static_cast<size_t>(ty) * tiles_x + tx) * tile_n * tile_n; }
+    const float* tile(int tx, int ty) const { return data + (static_cast<size_t>(ty) * tiles_x + tx) * tile_n * tile_n; }
+    float& at(int i, int j) { return tile(i / tile_n, j / tile_n)[(j % tile_n) * tile_n + i % tile_n]; }
+    float at(int i, int j) const { return tile(i / tile_n, j / tile_n)[(j % tile_n) * tile_n + i % tile_n]; }
+
+    // Paging hints for one row of tiles: read ahead, and write back + drop from memory
+    void prefetchRow(int ty) const;
+    void releaseRow(int ty) const;
+
+    // Runs kernel(tx, ty, tile) over every tile in file order; tiles of one row run in parallel
+    template <typename Kernel>
+    void stream(Kernel &&kernel) {
+        std::vector<int> cols(tiles_x);
+        std::iota(cols.begin(), cols.end(), 0);
+        const int report_every = std::max(1, tiles_y / 10);
+        auto start = std::chrono::high_resolution_clock::now();
+
+        prefetchRow(0);
+        for (int ty = 0; ty < tiles_y; ++ty) {
+            if (ty + 1 < tiles_y) prefetchRow(ty + 1);
+            std::for_each(std::execution::par, cols.begin(), cols.end(), [&](int tx) {
+                kernel(tx, ty, tile(tx, ty));
+            });
+            releaseRow(ty);
+
+            if ((ty + 1) % report_every == 0 && ty + 1 < tiles_y) {
+                const double s = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+                const double mb = static_cast<double>(ty + 1) / tiles_y * mapped_bytes / (1024.0 * 1024.0);
+                std::cout << "  Streamed " << (ty + 1) << "/" << tiles_y << " tile rows (" << static_cast<int>(mb / s)
+                          << " MB/s)" << std::endl;
+            }
+        }
+    }
+
+    // Point-sampled w x h preview of the whole field (pixel centres)
+    void downsample(std::vector<float> &out, int w, int h) const;
+
+private:
+    float *data = nullptr;
+    size_t mapped_bytes = 0;
+    bool drop_behind = false;  // Release finished rows (mapping larger than the resident limit)
+    int nx = 0, ny = 0;
+    int tile_n = 0, tiles_x = 0, tiles_y = 0;
+#ifdef _WIN32
+    void *file_handle = nullptr;
+    void *mapping_handle = nullptr;
+#else
+    int fd = -1;
+#endif
+
+    size_t rowBytes() const { return static_cast<size_t>(tiles_x) * tile_n * tile_n * sizeof(float); }
+};
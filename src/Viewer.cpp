@@ -0,0 +1,159 @@
+#include "Viewer.hpp"
+#include "Renderer.hpp"
+#include "Stream.hpp"
+#include <raylib.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+struct ViewerState {
+    std::mutex m;
+    std::vector<float> latest;
+    int w = 0, h = 0;
+    float range = 1.0f;
+    long long step = 0;
+    bool fresh = false;
+    std::atomic<bool> connected{true};
+
+    // Statistics (guarded by m)
+    size_t frames = 0, bytes = 0, tiles = 0;
+    double latency_sum_ms = 0.0, latency_max_ms = 0.0;
+};
+
+void receiveLoop(Socket &sock, ViewerState &state) {
+    FrameDecoder decoder;
+    std::vector<uint8_t> payload;
+    while (true) {
+        uint16_t type = 0;
+        if (!receiveMessage(sock, type, payload)) break;
+        if (type != stream::frame_message) continue;
+        if (!decoder.apply(payload.data(), payload.size())) {
+            std::cerr << "Viewer: undecodable frame - disconnecting\n";
+            break;
+        }
+        const double latency_ms = (stream::nowNs() - decoder.sentNs()) / 1e6;
+        std::lock_guard<std::mutex> lock(state.m);
+        state.latest = decoder.field();
+        state.w = decoder.width();
+        state.h = decoder.height();
+        state.range = decoder.quantRange();
+        state.step = decoder.step();
+        state.fresh = true;
+        ++state.frames;
+        state.bytes += payload.size() + stream::header_bytes;
+        state.tiles += decoder.tiles();
+        state.latency_sum_ms += latency_ms;
+        state.latency_max_ms = std::max(state.latency_max_ms, latency_ms);
+    }
+    state.connected = false;
+}
+}
+
+int runViewer(const std::string &endpoint) {
+    std::cout << "Connecting to field stream " << endpoint << "..." << std::endl;
+    Socket sock;
+    for (int attempt = 0; attempt < 50 && !sock.valid(); ++attempt) {
+        sock = Socket::connect(endpoint);
+        if (!sock.valid()) std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    }
+    if (!sock.valid()) {
+        std::cerr << "Could not connect to " << endpoint << "\n";
+        return 1;
+    }
+
+    ViewerState state;
+    std::thread receiver([&] { receiveLoop(sock, state); });
+
+    // The first keyframe fixes the window contents
+    while (state.connected) {
+        {
+            std::lock_guard<std::mutex> lock(state.m);
+            if (state.fresh) break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    if (!state.connected) {
+        receiver.join();
+        std::cerr << "Stream closed before the first frame\n";
+        return 1;
+    }
+
+    InitWindow(1400, 1000, ("Magnetic Field Simulator - Remote View (" + endpoint + ")").c_str());
+    SetTargetFPS(60);
+
+    std::vector<float> display;
+    int w = 0, h = 0;
+    float default_range = 1.0f;
+    std::unique_ptr<Renderer> renderer;
+    auto last_report = std::chrono::steady_clock::now();
+    size_t reported_frames = 0, reported_bytes = 0;
+
+    while (!WindowShouldClose()) {
+        {
+            std::lock_guard<std::mutex> lock(state.m);
+            if (state.fresh) {
+                std::swap(display, state.latest);
+                state.fresh = false;
+                if (state.w != w || state.h != h) {
+                    w = state.w;
+                    h = state.h;
+                    default_range = 0.5f * state.range;  // Servers quantize over twice the colour range by default
+                    renderer = std::make_unique<Renderer>(w, h, default_range);
+                }
+            }
+        }
+
+        float range = static_cast<float>(renderer->getColorRange());
+        if (IsKeyDown(KEY_UP)) range += 0.05f;
+        if (IsKeyDown(KEY_DOWN)) range = std::max(0.1f, range - 0.05f);
+        if (IsKeyDown(KEY_RIGHT)) range += 0.02f;
+        if (IsKeyDown(KEY_LEFT)) range = std::max(0.1f, range - 0.02f);
+        if (IsKeyPressed(KEY_R)) range = default_range;
+        if (range != static_cast<float>(renderer->getColorRange())) renderer->setColorRange(range);
+
+        renderer->render(display);
+
+        const auto now = std::chrono::steady_clock::now();
+        if (now - last_report >= std::chrono::seconds(5)) {
+            std::lock_guard<std::mutex> lock(state.m);
+            const size_t frames = state.frames - reported_frames;
+            const double seconds = std::chrono::duration<double>(now - last_report).count();
+            if (frames > 0) {
+                std::cout << "?? Stream step " << state.step << ": " << std::fixed << std::setprecision(1)
+                          << (frames / seconds) << " frames/s, " << ((state.bytes - reported_bytes) / 1024.0 / frames)
+                          << " KB/frame, " << ((state.bytes - reported_bytes) / 1024.0 / seconds) << " KB/s, latency avg "
+                          << std::setprecision(2) << (state.latency_sum_ms / state.frames) << "ms max "
+                          << state.latency_max_ms << "ms" << std::defaultfloat << std::endl;
+            }
+            reported_frames = state.frames;
+            reported_bytes = state.bytes;
+            last_report = now;
+        }
+        if (!state.connected) {
+            std::cout << "Stream closed by the solver" << std::endl;
+            break;
+        }
+    }
+
+    renderer.reset();
+    CloseWindow();
+    sock.shutdown();
+    receiver.join();
+    sock.close();
+
+    std::cout << "?? Viewer: " << state.frames << " frames, " << (state.bytes >> 10) << " KB received";
+    if (state.frames > 0) {
+        std::cout << ", " << std::fixed << std::setprecision(2) << (static_cast<double>(state.tiles) / state.frames)
+                  << " tiles/frame, latency avg " << (state.latency_sum_ms / state.frames) << "ms max "
+                  << state.latency_max_ms << "ms" << std::defaultfloat;
+    }
+    std::cout << std::endl;
+    return 0;
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+#include <string>
+
+// em2d --view <endpoint>: thin client for a solver started with streaming enabled
+// Frames are decoded on a receiver thread and drawn with the regular Renderer
+// (same colour map and legend); bandwidth and latency are printed periodically.
+int runViewer(const std::string &endpoint);
@@ -0,0 +1,83 @@
+#include "WorkStealingPool.hpp"
+#include <algorithm>
+
+thread_local const WorkStealingPool* WorkStealingPool::worker_pool = nullptr;
+thread_local int WorkStealingPool::worker_index = -1;
+
+WorkStealingPool::WorkStealingPool(int threads) {
+    const int n = threads > 0 ? threads : std::max(1u, std::thread::hardware_concurrency());
+    for (int k = 0; k < n; ++k) queues.push_back(std::make_unique<Queue>());
+    for (int k = 0; k < n; ++k) workers.emplace_back([this, k] { workerLoop(k); });
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> lock(idle_m);
+        stopping = true;
+    }
+    idle_cv.notify_all();
+    for (auto &t : workers) t.join();
+}
+
+void WorkStealingPool::submit(Task task) {
+    const size_t target = worker_pool == this ? static_cast<size_t>(worker_index)
+                                            : next_queue.fetch_add(1) % queues.size();
+    pending.fetch_add(1);
+    {
+        std::lock_guard<std::mutex> lock(queues[target]->m);
+        queues[target]->tasks.push_back(std::move(task));
+        queued.fetch_add(1);
+    }
+    // Taking idle_m orders the push before any sleeping worker re-checks `queued`
+    { std::lock_guard<std::mutex> lock(idle_m); }
+    idle_cv.notify_one();
+}
+
+void WorkStealingPool::wait() {
+    std::unique_lock<std::mutex> lock(idle_m);
+    done_cv.wait(lock, [this] { return pending.load() == 0; });
+}
+
+bool WorkStealingPool::tryRun(int self) {
+    Task task;
+    {
+        Queue &own = *queues[self];
+        std::lock_guard<std::mutex> lock(own.m);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            queued.fetch_sub(1);
+        }
+    }
+    const int n = static_cast<int>(queues.size());
+    for (int k = 1; !task && k < n; ++k) {
+        Queue &victim = *queues[(self + k) % n];
+        std::lock_guard<std::mutex> lock(victim.m);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            queued.fetch_sub(1);
+            steal_count.fetch_add(1);
+        }
+    }
+    if (!task) return false;
+
+    task();
+    executed_count.fetch_add(1);
+    if (pending.fetch_sub(1) == 1) {
+        std::lock_guard<std::mutex> lock(idle_m);
+        done_cv.notify_all();
+    }
+    return true;
+}
+
+void WorkStealingPool::workerLoop(int self) {
+    worker_pool = this;
+    worker_index = self;
+    while (true) {
+        if (tryRun(self)) continue;
+        std::unique_lock<std::mutex> lock(idle_m);
+        idle_cv.wait(lock, [this] { return stopping || queued.load() > 0; });
+        if (stopping && queued.load() == 0) return;
+    }
+}
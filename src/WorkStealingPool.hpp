@@ -0,0 +1,58 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads, each with its own task deque
+// Owners push and pop at the back (most recently queued, cache-warm); idle workers
+// steal from the front of another worker's deque, so tasks of very different cost
+// balance out without every thread contending on one shared queue.
+class WorkStealingPool {
+public:
+    using Task = std::function<void()>;
+
+    explicit WorkStealingPool(int threads = 0);  // 0 = hardware concurrency
+    ~WorkStealingPool();
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    int size() const { return static_cast<int>(workers.size()); }
+
+    // From a worker thread the task goes to that worker's own deque, otherwise round-robin
+    void submit(Task task);
+    void wait();  // Blocks until every submitted task has finished
+
+    size_t steals() const { return steal_count.load(); }
+    size_t executed() const { return executed_count.load(); }
+
+private:
+    struct Queue {
+        std::mutex m;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+    std::atomic<size_t> queued{0};      // Tasks sitting in deques
+    std::atomic<size_t> pending{0};     // Submitted but not finished
+    std::atomic<size_t> next_queue{0};
+    std::atomic<size_t> steal_count{0};
+    std::atomic<size_t> executed_count{0};
+    bool stopping = false;
+    std::mutex idle_m;
+    std::condition_variable idle_cv;
+    std::condition_variable done_cv;
+
+    static thread_local const WorkStealingPool* worker_pool;
+    static thread_local int worker_index;
+
+    bool tryRun(int self);
+    void workerLoop(int self);
+};
@@ -0,0 +1,241 @@
+#include "YeeSolver.hpp"
+#include "CPML.hpp"
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+namespace {
+
+// Row kernels; restrict-qualified so the blocked variants vectorize without alias checks
+template <typename Real, bool Blocked>
+void rowHy(Real *__restrict hy, const Real *__restrict ez, const float *__restrict chy, int n) {
+    using T = precision::Traits<Real>;
+    using Acc = typename T::Acc;
+    kernel::forColumns<Blocked>(0, n, [&](int i) {
+        hy[i] = T::store(T::load(hy[i]) + static_cast<Acc>(chy[i]) * (T::load(ez[i+1]) - T::load(ez[i])));
+    });
+}
+
+template <typename Real, bool Blocked>
+void rowHx(Real *__restrict hx, const Real *__restrict ez0, const Real *__restrict ez1, float chx, int n) {
+    using T = precision::Traits<Real>;
+    using Acc = typename T::Acc;
+    const Acc c = static_cast<Acc>(chx);
+    kernel::forColumns<Blocked>(0, n, [&](int i) {
+        hx[i] = T::store(T::load(hx[i]) - c * (T::load(ez1[i]) - T::load(ez0[i])));
+    });
+}
+
+template <typename Real, bool Blocked>
+void rowEz(Real *__restrict ez, const Real *__restrict hy, const Real *__restrict hx0, const Real *__restrict hx1,
+           const float *__restrict ce, const float *__restrict inv_dx, float inv_dy, int i0, int i1) {
+    using T = precision::Traits<Real>;
+    using Acc = typename T::Acc;
+    const Acc idy = static_cast<Acc>(inv_dy);
+    kernel::forColumns<Blocked>(i0, i1, [&](int i) {
+        ez[i] = T::store(T::load(ez[i]) + static_cast<Acc>(ce[i]) *
+                         ((T::load(hy[i]) - T::load(hy[i-1])) * static_cast<Acc>(inv_dx[i]) - (T::load(hx1[i]) - T::load(hx0[i])) * idy));
+    });
+}
+
+}
+
+template <typename Real, typename Kernel>
+YeeSolver<Real, Kernel>::YeeSolver(const YeeLayout &layout)
+: L(layout), cells(static_cast<size_t>(layout.nx) * layout.ny) {
+    if constexpr (std::is_same_v<Real, float>) {
+        fields = {L.ez->data(), L.hx->data(), L.hy->data()};
+    } else {
+        own_ez.assign(cells, Real(0.0f));
+        own_hx.assign(cells, Real(0.0f));
+        own_hy.assign(cells, Real(0.0f));
+        fields = {own_ez.data(), own_hx.data(), own_hy.data()};
+        if constexpr (std::is_same_v<Kernel, kernel::Pinned>) {
+            // Place each row block on the node of the worker that updates it (FDTD places the float fields)
+            for (Real *f : fields) PinnedPool::shared().firstTouch(f, L.ny, static_cast<size_t>(L.nx), Real(0.0f));
+        }
+    }
+}
+
+template <typename Real, typename Kernel>
+void YeeSolver<Real, Kernel>::updateH() {
+    const float *chy = L.ch_hy;
+    const float *chx = L.ch_hx;
+    const int w = L.nx;
+    const int last_row = L.ny - 1;
+    Real *ez = fields[0], *hx = fields[1], *hy = fields[2];
+
+    // Row-parallel, unit-stride inner loops; Hx has no Ez neighbour above the last row
+    Kernel::forRows(*L.rows, 0, L.ny, [=](int j) {
+        const size_t row = static_cast<size_t>(j) * w;
+        rowHy<Real, Kernel::blocked>(hy + row, ez + row, chy, w - 1);
+        if (j < last_row) rowHx<Real, Kernel::blocked>(hx + row, ez + row, ez + row + w, chx[j], w);
+    });
+}
+
+template <typename Real, typename Kernel>
+void YeeSolver<Real, Kernel>::updateE() {
+    const float *inv_dx = L.inv_dx;
+    const float *inv_dy = L.inv_dy;
+    const float *cez = L.cez;
+    const int w = L.nx;
+    const int i1 = L.ez_i1;
+    const bool wrap_x = L.wrap_x;
+    const size_t last_row = static_cast<size_t>(L.ny - 1) * w;
+    Real *ez = fields[0];
+    const Real *hx = fields[1], *hy = fields[2];
+
+    // Outer ring of Ez stays zero (PEC walls behind the CPML) unless a symmetry seam owns it
+    Kernel::forRows(*L.rows, L.ez_j0, L.ez_j1, [=](int j) {
+        using T = precision::Traits<Real>;
+        using Acc = typename T::Acc;
+        const size_t row = static_cast<size_t>(j) * w;
+        const Real *hx1 = hx + row;
+        const Real *hx0 = j > 0 ? hx1 - w : hx + last_row;
+        const Real *hy_row = hy + row;
+        Real *ez_row = ez + row;
+        rowEz<Real, Kernel::blocked>(ez_row, hy_row, hx0, hx1, cez + row, inv_dx, inv_dy[j], 1, i1);
+        if (wrap_x) {
+            ez_row[0] = T::store(T::load(ez_row[0]) + static_cast<Acc>(cez[row]) *
+                                 ((T::load(hy_row[0]) - T::load(hy_row[w-1])) * static_cast<Acc>(inv_dx[0]) -
+                                  (T::load(hx1[0]) - T::load(hx0[0])) * static_cast<Acc>(inv_dy[j])));
+        }
+    });
+}
+
+template <typename Real, typename Kernel>
+void YeeSolver<Real, Kernel>::applySymmetryH() {
+    using T = precision::Traits<Real>;
+    using Acc = typename T::Acc;
+    const int w = L.nx, h = L.ny;
+    const size_t last_row = static_cast<size_t>(h - 1) * w;
+    const Real *ez = fields[0];
+    Real *hx = fields[1], *hy = fields[2];
+
+    // Periodic seams take the neighbour from the opposite side; PMC planes mirror
+    // the tangential H with flipped sign so that Ez is even across the plane
+    if (L.periodic_x) {
+        const Acc chy = static_cast<Acc>(L.ch_hy[w - 1]);
+        for (int j = 0; j < h; ++j) {
+            const size_t row = static_cast<size_t>(j) * w;
+            hy[row + w - 1] = T::store(T::load(hy[row + w - 1]) + chy * (T::load(ez[row]) - T::load(ez[row + w - 1])));
+        }
+    } else if (L.pmc_x) {
+        for (int j = 0; j < h; ++j) {
+            const size_t row = static_cast<size_t>(j) * w;
+            hy[row + w - 1] = T::store(-T::load(hy[row + w - 2]));
+        }
+    }
+
+    if (L.periodic_y) {
+        const Acc chx = static_cast<Acc>(L.ch_hx[h - 1]);
+        for (int i = 0; i < w; ++i) {
+            hx[last_row + i] = T::store(T::load(hx[last_row + i]) - chx * (T::load(ez[i]) - T::load(ez[last_row + i])));
+        }
+    } else if (L.pmc_y) {
+        for (int i = 0; i < w; ++i) hx[last_row + i] = T::store(-T::load(hx[last_row - w + i]));
+    }
+}
+
+template <typename Real, typename Kernel>
+void YeeSolver<Real, Kernel>::step() {
+    // Interior kernels are branch-free; CPML corrections run only over the boundary strips
+    updateH();
+    L.cpml->correctH<Real>(fields[0], fields[1], fields[2]);
+    applySymmetryH();
+    updateE();
+    L.cpml->correctE<Real>(fields[1], fields[2], fields[0], L.cez);
+    ++generation;
+}
+
+template <typename Real, typename Kernel>
+void YeeSolver<Real, Kernel>::addEz(size_t node, float value) {
+    using T = precision::Traits<Real>;
+    fields[0][node] = T::store(T::load(fields[0][node]) + value);
+    ++generation;
+}
+
+template <typename Real, typename Kernel>
+void YeeSolver<Real, Kernel>::reset() {
+    for (Real *f : fields) {
+        Kernel::forRows(*L.rows, 0, L.ny, [=, w = static_cast<size_t>(L.nx)](int j) {
+            std::fill(f + j * w, f + (j + 1) * w, Real(0.0f));
+        });
+    }
+    ++generation;
+}
+
+template <typename Real, typename Kernel>
+const std::vector<float>& YeeSolver<Real, Kernel>::floatField(YeeField f) const {
+    const int k = static_cast<int>(f);
+    std::vector<float> &dst = *std::array<std::vector<float>*, 3>{L.ez, L.hx, L.hy}[k];
+    if constexpr (!std::is_same_v<Real, float>) {
+        if (mirrored[k] != generation || dst.size() != cells) {
+            dst.resize(cells);
+            const Real *src = fields[k];
+            float *out = dst.data();
+            Kernel::forRows(*L.rows, 0, L.ny, [=, w = L.nx](int j) {
+                const size_t row = static_cast<size_t>(j) * w;
+                for (int i = 0; i < w; ++i) out[row + i] = static_cast<float>(src[row + i]);
+            });
+            mirrored[k] = generation;
+        }
+    }
+    return dst;
+}
+
+template <typename Real, typename Kernel>
+void YeeSolver<Real, Kernel>::gather(YeeField f, const size_t *nodes, size_t n, float *out) const {
+    using T = precision::Traits<Real>;
+    const Real *src = fields[static_cast<int>(f)];
+    for (size_t k = 0; k < n; ++k) out[k] = static_cast<float>(T::load(src[nodes[k]]));
+}
+
+template <typename Real, typename Kernel>
+void YeeSolver<Real, Kernel>::pack(YeeField f, std::vector<float> &out) const {
+    const size_t bytes = cells * sizeof(Real);
+    out.assign((bytes + sizeof(float) - 1) / sizeof(float), 0.0f);
+    std::memcpy(out.data(), fields[static_cast<int>(f)], bytes);
+}
+
+template <typename Real, typename Kernel>
+bool YeeSolver<Real, Kernel>::unpack(YeeField f, const std::vector<float> &in) {
+    const size_t bytes = cells * sizeof(Real);
+    if (in.size() != (bytes + sizeof(float) - 1) / sizeof(float)) return false;
+    std::memcpy(static_cast<void*>(fields[static_cast<int>(f)]), in.data(), bytes);
+    ++generation;
+    return true;
+}
+
+template class YeeSolver<float, kernel::Scalar>;
+template class YeeSolver<float, kernel::Simd>;
+template class YeeSolver<float, kernel::Threaded>;
+template class YeeSolver<float, kernel::Pinned>;
+template class YeeSolver<double, kernel::Scalar>;
+template class YeeSolver<double, kernel::Simd>;
+template class YeeSolver<double, kernel::Threaded>;
+template class YeeSolver<double, kernel::Pinned>;
+template class YeeSolver<Half, kernel::Scalar>;
+template class YeeSolver<Half, kernel::Simd>;
+template class YeeSolver<Half, kernel::Threaded>;
+template class YeeSolver<Half, kernel::Pinned>;
+
+namespace {
+template <typename Real>
+std::unique_ptr<YeeCore> makeForKernel(SolverKernel kernel, const YeeLayout &layout) {
+    switch (kernel) {
+    case SolverKernel::Scalar: return std::make_unique<YeeSolver<Real, kernel::Scalar>>(layout);
+    case SolverKernel::Simd: return std::make_unique<YeeSolver<Real, kernel::Simd>>(layout);
+    case SolverKernel::Pinned: return std::make_unique<YeeSolver<Real, kernel::Pinned>>(layout);
+    default: return std::make_unique<YeeSolver<Real, kernel::Threaded>>(layout);
+    }
+}
+}
+
+std::unique_ptr<YeeCore> makeYeeCore(SolverPrecision precision, SolverKernel kernel, const YeeLayout &layout) {
+    switch (precision) {
+    case SolverPrecision::Double: return makeForKernel<double>(kernel, layout);
+    case SolverPrecision::Half: return makeForKernel<Half>(kernel, layout);
+    default: return makeForKernel<float>(kernel, layout);
+    }
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "SolverPolicy.hpp"
+
+class CPML;
+
+// What the in-memory Yee update needs from the FDTD grid; everything stays owned by FDTD
+// (coefficients are fp32 material data at every precision and may change in place).
+struct YeeLayout {
+    int nx = 0, ny = 0;
+    int ez_i1 = 0, ez_j0 = 1, ez_j1 = 0;  // Updated Ez columns [1, ez_i1) and rows [ez_j0, ez_j1)
+    bool wrap_x = false;                  // Column 0 is a periodic seam and is updated too
+    bool periodic_x = false, pmc_x = false, periodic_y = false, pmc_y = false;
+    const float *cez = nullptr;           // c0*dt/eps_r per node
+    const float *ch_hx = nullptr;         // c0*dt/spacing per row (Hx update)
+    const float *ch_hy = nullptr;         // c0*dt/spacing per column (Hy update)
+    const float *inv_dx = nullptr;        // 1/dual cell width per column
+    const float *inv_dy = nullptr;        // 1/dual cell width per row
+    const std::vector<int> *rows = nullptr;
+    CPML *cpml = nullptr;
+    // fp32 fields: the storage itself at float precision, otherwise conversion targets for floatField()
+    std::vector<float> *ez = nullptr, *hx = nullptr, *hy = nullptr;
+};
+
+enum class YeeField { Ez = 0, Hx = 1, Hy = 2 };
+
+// Time-domain update of the in-memory grid for one <precision, kernel> combination
+class YeeCore {
+public:
+    virtual ~YeeCore() = default;
+
+    virtual const char* precisionName() const = 0;
+    virtual const char* kernelName() const = 0;
+    virtual size_t bytesPerCell() const = 0;  // Ez + Hx + Hy storage
+
+    // H update, CPML H correction, symmetry seams, E update, CPML E correction
+    virtual void step() = 0;
+    virtual void addEz(size_t node, float value) = 0;  // Soft source
+    virtual void reset() = 0;
+
+    // fp32 field: the storage itself at float precision, otherwise converted when it changed since the last call
+    virtual const std::vector<float>& floatField(YeeField f) const = 0;
+    // out[k] = field at nodes[k] as fp32, without mirroring the whole field (probes)
+    virtual void gather(YeeField f, const size_t *nodes, size_t n, float *out) const = 0;
+
+    // Raw storage packed into float words for checkpoints (bit-exact round trip at every precision)
+    virtual void pack(YeeField f, std::vector<float> &out) const = 0;
+    virtual bool unpack(YeeField f, const std::vector<float> &in) = 0;
+};
+
+template <typename Real, typename Kernel>
+class YeeSolver final : public YeeCore {
+public:
+    explicit YeeSolver(const YeeLayout &layout);
+
+    const char* precisionName() const override { return precision::Traits<Real>::name; }
+    const char* kernelName() const override { return Kernel::name; }
+    size_t bytesPerCell() const override { return 3 * sizeof(Real); }
+
+    void step() override;
+    void addEz(size_t node, float value) override;
+    void reset() override;
+    const std::vector<float>& floatField(YeeField f) const override;
+    void gather(YeeField f, const size_t *nodes, size_t n, float *out) const override;
+    void pack(YeeField f, std::vector<float> &out) const override;
+    bool unpack(YeeField f, const std::vector<float> &in) override;
+
+private:
+    YeeLayout L;
+    size_t cells = 0;
+    std::vector<Real> own_ez, own_hx, own_hy;  // Empty at float precision
+    std::array<Real*, 3> fields{};
+    uint64_t generation = 0;                   // Bumped whenever the storage changes
+    mutable std::array<uint64_t, 3> mirrored{~0ull, ~0ull, ~0ull};
+
+    void updateH();
+    void updateE();
+    void applySymmetryH();
+};
+
+extern template class YeeSolver<float, kernel::Scalar>;
+extern template class YeeSolver<float, kernel::Simd>;
+extern template class YeeSolver<float, kernel::Threaded>;
+extern template class YeeSolver<float, kernel::Pinned>;
+extern template class YeeSolver<double, kernel::Scalar>;
+extern template class YeeSolver<double, kernel::Simd>;
+extern template class YeeSolver<double, kernel::Threaded>;
+extern template class YeeSolver<double, kernel::Pinned>;
+extern template class YeeSolver<Half, kernel::Scalar>;
+extern template class YeeSolver<Half, kernel::Simd>;
+extern template class YeeSolver<Half, kernel::Threaded>;
+extern template class YeeSolver<Half, kernel::Pinned>;
+
+// Runtime selector over the explicit instantiations above
+std::unique_ptr<YeeCore> makeYeeCore(SolverPrecision precision, SolverKernel kernel, const YeeLayout &layout);
@@ -0,0 +1,228 @@
+#include "em2d_c.h"
+#include "Config.hpp"
+#include "FDTD.hpp"
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <string>
+
+struct em2d_sim {
+    Config cfg;
+    std::unique_ptr<FDTD> sim;
+    std::string error;
+};
+
+namespace {
+thread_local std::string create_error;  // Reported by em2d_last_error(NULL)
+
+int fail(em2d_sim *s, int status, const std::string &message) {
+    if (s) s->error = message;
+    else create_error = message;
+    return status;
+}
+
+// C++ exceptions must never cross the C boundary
+template <typename F>
+int guarded(em2d_sim *s, F &&body) {
+    try {
+        return body();
+    } catch (std::exception &e) {
+        return fail(s, EM2D_ERROR_INTERNAL, e.what());
+    } catch (...) {
+        return fail(s, EM2D_ERROR_INTERNAL, "unknown error");
+    }
+}
+
+em2d_sim *create(std::optional<Config> cfg, const char *what) {
+    if (!cfg) {
+        fail(nullptr, EM2D_ERROR_CONFIG, std::string("could not load config ") + what);
+        return nullptr;
+    }
+    auto handle = std::make_unique<em2d_sim>();
+    handle->cfg = std::move(*cfg);
+    handle->sim = std::make_unique<FDTD>(handle->cfg.grid);
+    for (const auto &m : handle->cfg.materials) handle->sim->addMaterialBlock(m.x0, m.y0, m.w, m.h, m.eps_r);
+    for (const auto &s : handle->cfg.sources) handle->sim->addSource(s);
+    for (const auto &m : handle->cfg.magnets) handle->sim->addMagnet(m);
+    return handle.release();
+}
+
+em2d_sim *createGuarded(std::optional<Config> (*load)(const std::string&), const char *arg, const char *what) {
+    try {
+        return create(load(arg), what);
+    } catch (std::exception &e) {
+        fail(nullptr, EM2D_ERROR_CONFIG, std::string("could not create simulation: ") + e.what());
+    } catch (...) {
+        fail(nullptr, EM2D_ERROR_INTERNAL, "could not create simulation");
+    }
+    return nullptr;
+}
+
+// Static scenes compute (or recompute after magnet edits) their field on step(); time-domain ones are left alone
+void ensureField(FDTD &sim) {
+    if (!sim.isTimeDomain()) sim.step();
+}
+}
+
+extern "C" {
+
+int32_t em2d_abi_version(void) {
+    return EM2D_ABI_VERSION;
+}
+
+em2d_sim *em2d_create_from_file(const char *config_path) {
+    if (!config_path) {
+        fail(nullptr, EM2D_ERROR_ARGUMENT, "config_path is NULL");
+        return nullptr;
+    }
+    return createGuarded(&Config::loadFromFile, config_path, (std::string("file ") + config_path).c_str());
+}
+
+em2d_sim *em2d_create_from_string(const char *config_json) {
+    if (!config_json) {
+        fail(nullptr, EM2D_ERROR_ARGUMENT, "config_json is NULL");
+        return nullptr;
+    }
+    return createGuarded(&Config::loadFromString, config_json, "string (invalid JSON)");
+}
+
+void em2d_destroy(em2d_sim *sim) {
+    delete sim;
+}
+
+const char *em2d_last_error(const em2d_sim *sim) {
+    return sim ? sim->error.c_str() : create_error.c_str();
+}
+
+int em2d_step(em2d_sim *sim, int32_t steps) {
+    if (!sim) return fail(nullptr, EM2D_ERROR_ARGUMENT, "sim is NULL");
+    if (steps < 0) return fail(sim, EM2D_ERROR_ARGUMENT, "steps must not be negative");
+    return guarded(sim, [&] {
+        if (!sim->sim->isTimeDomain()) sim->sim->step();
+        else if (steps > 0 && !sim->sim->advance(steps)) return fail(sim, EM2D_ERROR_INTERNAL, "decomposed run failed - a solver process did not start or exited");
+        return static_cast<int>(EM2D_OK);
+    });
+}
+
+int em2d_reset(em2d_sim *sim) {
+    if (!sim) return fail(nullptr, EM2D_ERROR_ARGUMENT, "sim is NULL");
+    return guarded(sim, [&] {
+        if (sim->sim->isTimeDomain()) sim->sim->reset();
+        return static_cast<int>(EM2D_OK);
+    });
+}
+
+int64_t em2d_current_step(const em2d_sim *sim) {
+    return sim ? sim->sim->getStep() : 0;
+}
+
+int32_t em2d_is_time_domain(const em2d_sim *sim) {
+    return sim && sim->sim->isTimeDomain() ? 1 : 0;
+}
+
+uint64_t em2d_field_version(const em2d_sim *sim) {
+    return sim ? sim->sim->fieldVersion() : 0;
+}
+
+int32_t em2d_magnet_count(const em2d_sim *sim) {
+    return sim ? static_cast<int32_t>(sim->sim->magnets().size()) : 0;
+}
+
+int em2d_get_magnet(const em2d_sim *sim, int32_t index, em2d_magnet *out) {
+    if (!sim || !out) return fail(const_cast<em2d_sim*>(sim), EM2D_ERROR_ARGUMENT, "sim or out is NULL");
+    const auto &magnets = sim->sim->magnets();
+    if (index < 0 || static_cast<size_t>(index) >= magnets.size()) {
+        return fail(const_cast<em2d_sim*>(sim), EM2D_ERROR_ARGUMENT, "magnet index out of range");
+    }
+    const MagnetConfig &m = magnets[index];
+    *out = em2d_magnet{};
+    out->x = m.x;
+    out->y = m.y;
+    out->moment_x = m.moment_x;
+    out->moment_y = m.moment_y;
+    out->strength = m.strength;
+    std::strncpy(out->name, m.name.c_str(), sizeof(out->name) - 1);
+    return EM2D_OK;
+}
+
+int em2d_add_magnet(em2d_sim *sim, const em2d_magnet *magnet, int32_t *index_out) {
+    if (!sim || !magnet) return fail(sim, EM2D_ERROR_ARGUMENT, "sim or magnet is NULL");
+    return guarded(sim, [&] {
+        MagnetConfig m;
+        m.x = magnet->x;
+        m.y = magnet->y;
+        m.moment_x = magnet->moment_x;
+        m.moment_y = magnet->moment_y;
+        m.strength = magnet->strength;
+        m.name.assign(magnet->name, strnlen(magnet->name, sizeof(magnet->name)));
+        if (m.name.empty()) m.name = "magnet";
+        sim->sim->addMagnet(m);
+        if (index_out) *index_out = static_cast<int32_t>(sim->sim->magnets().size() - 1);
+        return static_cast<int>(EM2D_OK);
+    });
+}
+
+int em2d_move_magnet(em2d_sim *sim, int32_t index, int32_t x, int32_t y) {
+    if (!sim) return fail(nullptr, EM2D_ERROR_ARGUMENT, "sim is NULL");
+    if (index < 0 || !sim->sim->moveMagnet(static_cast<size_t>(index), x, y)) {
+        return fail(sim, EM2D_ERROR_ARGUMENT, "magnet index out of range");
+    }
+    return EM2D_OK;
+}
+
+int em2d_field_region(em2d_sim *sim, em2d_field field, int32_t x0, int32_t y0, int32_t w, int32_t h,
+                      int32_t step_x, int32_t step_y, em2d_view *out) {
+    if (!sim || !out) return fail(sim, EM2D_ERROR_ARGUMENT, "sim or out is NULL");
+    return guarded(sim, [&] {
+        FDTD &s = *sim->sim;
+        ensureField(s);
+
+        const std::vector<float> *buffer = nullptr;
+        int width = s.meshWidth(), height = s.meshHeight();
+        switch (field) {
+        case EM2D_FIELD_EZ:
+            buffer = &s.getEz();
+            width = s.displayWidth();
+            height = s.displayHeight();
+            break;
+        case EM2D_FIELD_HX: buffer = &s.meshHx(); break;
+        case EM2D_FIELD_HY: buffer = &s.meshHy(); break;
+        case EM2D_FIELD_EPS_R: buffer = &s.meshEpsR(); break;
+        default: return fail(sim, EM2D_ERROR_ARGUMENT, "unknown field");
+        }
+        if (buffer->size() != static_cast<size_t>(width) * height) {
+            return fail(sim, EM2D_ERROR_UNAVAILABLE, "field is not held in memory for this grid");
+        }
+
+        if (step_x >= 1 && w < 0) w = (width - x0 + step_x - 1) / step_x;  // Negative extents run to the edge
+        if (step_y >= 1 && h < 0) h = (height - y0 + step_y - 1) / step_y;
+        if (step_x < 1 || step_y < 1 || w < 1 || h < 1 || x0 < 0 || y0 < 0 ||
+            x0 + static_cast<int64_t>(w - 1) * step_x >= width || y0 + static_cast<int64_t>(h - 1) * step_y >= height) {
+            return fail(sim, EM2D_ERROR_ARGUMENT, "region exceeds the field");
+        }
+
+        *out = em2d_view{};
+        out->data = buffer->data() + static_cast<size_t>(y0) * width + x0;
+        out->width = w;
+        out->height = h;
+        out->stride_x = static_cast<int64_t>(step_x) * sizeof(float);
+        out->stride_y = static_cast<int64_t>(step_y) * width * sizeof(float);
+        out->dtype = EM2D_DTYPE_FLOAT32;
+        out->field = field;
+        out->version = s.fieldVersion();
+        out->step = s.getStep();
+        return static_cast<int>(EM2D_OK);
+    });
+}
+
+int em2d_field_view(em2d_sim *sim, em2d_field field, em2d_view *out) {
+    return em2d_field_region(sim, field, 0, 0, -1, -1, 1, 1, out);
+}
+
+int32_t em2d_view_current(const em2d_sim *sim, const em2d_view *view) {
+    return sim && view && view->data && view->version == sim->sim->fieldVersion() ? 1 : 0;
+}
+
+}
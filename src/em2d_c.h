@@ -0,0 +1,120 @@
+/* Stable C interface to the EM2D solver core (library em2d_c)
+ *
+ * Host applications (C, Python via ctypes, C# via P/Invoke) create a simulation
+ * from a config file or JSON string, step it, edit magnets and read the field
+ * buffers in place through strided views - no copies, no serialization.
+ *
+ * Conventions
+ *   - Functions returning int report EM2D_OK (0) or a negative em2d_status;
+ *     em2d_last_error() describes the most recent failure.
+ *   - A handle is not thread-safe; use one handle per thread or serialize calls.
+ *     Separate handles are independent.
+ *   - Only fixed-size types cross the boundary; structs are only ever extended at
+ *     the end, and EM2D_ABI_VERSION changes on any incompatible change.
+ *
+ * View lifetime and versioning
+ *   A view borrows memory owned by the simulation. Its contents describe the
+ *   field at view.version and stay valid while em2d_field_version() returns that
+ *   same value; em2d_view_current() checks this. The data pointer itself remains
+ *   dereferenceable until the next mutating call on the handle (em2d_step,
+ *   em2d_reset, em2d_add_magnet, em2d_move_magnet, em2d_destroy), after which the
+ *   view must be taken again. Never write through a view.
+ */
+#ifndef EM2D_C_H
+#define EM2D_C_H
+
+#include <stdint.h>
+
+#if defined(_WIN32)
+#  if defined(EM2D_C_BUILD)
+#    define EM2D_API __declspec(dllexport)
+#  else
+#    define EM2D_API __declspec(dllimport)
+#  endif
+#else
+#  define EM2D_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define EM2D_ABI_VERSION 1
+
+typedef struct em2d_sim em2d_sim;  /* Opaque simulation handle */
+
+typedef enum em2d_status {
+    EM2D_OK = 0,
+    EM2D_ERROR_ARGUMENT = -1,     /* NULL handle/pointer or out-of-range parameter */
+    EM2D_ERROR_CONFIG = -2,       /* Config could not be read or parsed */
+    EM2D_ERROR_UNAVAILABLE = -3,  /* Field not held in this process (out-of-core, decomposed or adaptive grid) */
+    EM2D_ERROR_INTERNAL = -4      /* Unexpected failure inside the solver (e.g. out of memory) */
+} em2d_status;
+
+typedef enum em2d_field {
+    EM2D_FIELD_EZ = 0,     /* Display field (what the application renders), displayWidth x displayHeight */
+    EM2D_FIELD_HX = 1,     /* Solver mesh, mesh width x mesh height */
+    EM2D_FIELD_HY = 2,     /* Solver mesh */
+    EM2D_FIELD_EPS_R = 3   /* Relative permittivity on the solver mesh */
+} em2d_field;
+
+typedef enum em2d_dtype {
+    EM2D_DTYPE_FLOAT32 = 1
+} em2d_dtype;
+
+/* Element (x, y) lives at (const char*)data + x*stride_x + y*stride_y */
+typedef struct em2d_view {
+    const void *data;
+    int32_t width;       /* Elements along x */
+    int32_t height;      /* Elements along y */
+    int64_t stride_x;    /* Bytes between horizontal neighbours */
+    int64_t stride_y;    /* Bytes between vertical neighbours */
+    int32_t dtype;       /* em2d_dtype */
+    int32_t field;       /* em2d_field */
+    uint64_t version;    /* em2d_field_version() when the view was taken */
+    int64_t step;        /* Time step of the field */
+} em2d_view;
+
+typedef struct em2d_magnet {
+    int32_t x, y;        /* Display-grid cell */
+    double moment_x;
+    double moment_y;
+    double strength;
+    char name[64];       /* NUL-terminated; longer names are truncated */
+} em2d_magnet;
+
+EM2D_API int32_t em2d_abi_version(void);
+
+/* Return NULL on failure; em2d_last_error(NULL) then holds the reason for this thread */
+EM2D_API em2d_sim *em2d_create_from_file(const char *config_path);
+EM2D_API em2d_sim *em2d_create_from_string(const char *config_json);
+EM2D_API void em2d_destroy(em2d_sim *sim);
+EM2D_API const char *em2d_last_error(const em2d_sim *sim);
+
+/* Time-domain scenes advance `steps` time steps; static scenes (re)compute the magnet field if needed */
+EM2D_API int em2d_step(em2d_sim *sim, int32_t steps);
+EM2D_API int em2d_reset(em2d_sim *sim);  /* Rewinds a time-domain run to step 0; no-op for static scenes */
+EM2D_API int64_t em2d_current_step(const em2d_sim *sim);
+EM2D_API int32_t em2d_is_time_domain(const em2d_sim *sim);
+EM2D_API uint64_t em2d_field_version(const em2d_sim *sim);  /* Changes whenever any field buffer does */
+
+/* Magnets shape the static field, which is recomputed on the next em2d_step or view request;
+ * after em2d_move_magnet only the neighbourhoods of the old and new position are re-evaluated.
+ * Static scenes without magnets switch to the built-in default set when first computed. */
+EM2D_API int32_t em2d_magnet_count(const em2d_sim *sim);
+EM2D_API int em2d_get_magnet(const em2d_sim *sim, int32_t index, em2d_magnet *out);
+EM2D_API int em2d_add_magnet(em2d_sim *sim, const em2d_magnet *magnet, int32_t *index_out);
+EM2D_API int em2d_move_magnet(em2d_sim *sim, int32_t index, int32_t x, int32_t y);
+
+/* Zero-copy views. em2d_field_region takes every step_x-th / step_y-th element of
+ * [x0, x0 + w*step_x) x [y0, y0 + h*step_y); a negative w or h extends to the field edge. */
+EM2D_API int em2d_field_view(em2d_sim *sim, em2d_field field, em2d_view *out);
+EM2D_API int em2d_field_region(em2d_sim *sim, em2d_field field, int32_t x0, int32_t y0, int32_t w, int32_t h,
+                               int32_t step_x, int32_t step_y, em2d_view *out);
+EM2D_API int32_t em2d_view_current(const em2d_sim *sim, const em2d_view *view);  /* 1 while the view matches the field */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EM2D_C_H */
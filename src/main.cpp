@@ -1,23 +1,114 @@
 #include "FDTD.hpp"
 #include "Renderer.hpp"
 #include "Config.hpp"
+#include "Sweep.hpp"
+#include "Checkpoint.hpp"
+#include "Export.hpp"
+#include "Stream.hpp"
+#include "Viewer.hpp"
+#include "Benchmark.hpp"
+#include "Probe.hpp"
+#include "FluxLines.hpp"
+#include "ConfigWatch.hpp"
 #include <raylib.h>
 #include <iostream>
 #include <chrono>
 #include <iomanip>
+#include <string>
+#include <cstdlib>
+#include <algorithm>
+#include <csignal>
+#include <thread>
+#include <memory>
 
 // Ultra-High Resolution Magnetic Field Simulator
 // Performance optimized for 1024x1024 field computation
 // Real-time interactive visualization with adaptive FPS
 
-int main() {
+static volatile std::sig_atomic_t stop_requested = 0;
+
+static void requestStop(int) {
+    stop_requested = 1;
+}
+
+// Solver with the config's materials, sources and magnets; the viewer rebuilds it on grid or scene edits
+static std::unique_ptr<FDTD> buildScene(const Config &cfg) {
+    auto sim = std::make_unique<FDTD>(cfg.grid);
+
+    // Add materials from config
+    if (!cfg.materials.empty()) {
+        std::cout << "Adding " << cfg.materials.size() << " material blocks" << std::endl;
+        for (auto &m : cfg.materials) {
+            sim->addMaterialBlock(m.x0, m.y0, m.w, m.h, m.eps_r);
+        }
+    }
+
+    // Add sources from config
+    if (!cfg.sources.empty()) {
+        std::cout << "Adding " << cfg.sources.size() << " sources" << std::endl;
+        for (auto &s : cfg.sources) {
+            sim->addSource(s);
+        }
+    }
+
+    // Add magnets from config
+    std::cout << "Adding " << cfg.magnets.size() << " configured magnets" << std::endl;
+    for (auto &m : cfg.magnets) {
+        sim->addMagnet(m);
+    }
+    return sim;
+}
+
+int main(int argc, char **argv) {
     std::cout << "Starting Ultra-High Resolution Magnetic Field Simulator - FEMM Clone with Raylib..." << std::endl;
     
     Config cfg;
     
     // Try to load config from file first, with fallback to hardcoded values
     std::cout << "Attempting to load ultra-high resolution magnet configuration..." << std::endl;
-    auto cfg_opt = Config::loadFromFile("em2d_sfml/assets/config.json");
+    // Command line: [config.json] [--ranks N] [--precision float|double|half] [--kernel threaded|simd|scalar|pinned]
+    //               [--restart checkpoint] [--stream endpoint] [--headless]
+    //               | --sweep sweep.json | --view endpoint | --stream-selftest [config.json]
+    //               | --bench-kernels [config.json] [steps] | --bench-numa [config.json] [steps]
+    std::string config_path = "em2d_sfml/assets/config.json";
+    std::string restart_path;
+    std::string stream_endpoint;
+    bool headless = false;
+    int ranks_override = 0;
+    std::string precision_override, kernel_override;
+    for (int a = 1; a < argc; ++a) {
+        const std::string arg = argv[a];
+        if (arg == "--ranks" && a + 1 < argc) {
+            ranks_override = std::atoi(argv[++a]);
+        } else if (arg == "--precision" && a + 1 < argc) {
+            precision_override = argv[++a];
+        } else if (arg == "--kernel" && a + 1 < argc) {
+            kernel_override = argv[++a];
+        } else if (arg == "--restart" && a + 1 < argc) {
+            restart_path = argv[++a];
+        } else if (arg == "--stream" && a + 1 < argc) {
+            stream_endpoint = argv[++a];
+        } else if (arg == "--headless") {
+            headless = true;
+        } else if (arg == "--sweep" && a + 1 < argc) {
+            // Headless batch run - no window
+            return runSweep(argv[++a]);
+        } else if (arg == "--view" && a + 1 < argc) {
+            // Remote viewer of a streaming solver - no local simulation
+            return runViewer(argv[++a]);
+        } else if (arg == "--stream-selftest") {
+            return runStreamSelfTest(a + 1 < argc ? argv[a + 1] : "examples/pml_pulse_config.json");
+        } else if (arg == "--bench-kernels") {
+            return runKernelBenchmark(a + 1 < argc ? argv[a + 1] : "examples/pml_pulse_config.json",
+                                      a + 2 < argc ? std::atoi(argv[a + 2]) : 200);
+        } else if (arg == "--bench-numa") {
+            return runNumaBenchmark(a + 1 < argc ? argv[a + 1] : "examples/pml_pulse_config.json",
+                                    a + 2 < argc ? std::atoi(argv[a + 2]) : 200);
+        } else {
+            config_path = arg;
+        }
+    }
+    auto cfg_opt = Config::loadFromFile(config_path);
     if (cfg_opt) {
         cfg = *cfg_opt;
         std::cout << "Loaded configuration successfully!" << std::endl;
@@ -44,33 +135,66 @@ int main() {
         cfg.scenario = "optimized_high_resolution_fallback";
     }
 
+    // Command-line overrides, applied again to every hot-reloaded config
+    auto applyOverrides = [&](Config &c) {
+        if (ranks_override > 0) c.grid.decomposition.ranks = ranks_override;
+        if (!precision_override.empty()) c.grid.solver.precision = precision_override;
+        if (!kernel_override.empty()) c.grid.solver.kernel = kernel_override;
+        if (!stream_endpoint.empty()) {
+            c.stream.enabled = true;
+            c.stream.endpoint = stream_endpoint;
+        }
+    };
+    applyOverrides(cfg);
+
     std::cout << "Initializing magnetic field simulation..." << std::endl;
     
     // Performance timing
     auto start_time = std::chrono::high_resolution_clock::now();
     
-    FDTD sim(cfg.grid.nx, cfg.grid.ny, cfg.grid.dx, cfg.grid.dy);
+    std::unique_ptr<FDTD> sim = buildScene(cfg);
 
-    // Add materials from config
-    if (!cfg.materials.empty()) {
-        std::cout << "Adding " << cfg.materials.size() << " material blocks" << std::endl;
-        for (auto &m : cfg.materials) {
-            sim.addMaterialBlock(m.x0, m.y0, m.w, m.h, m.eps_r);
-        }
+    // Resume a time-domain run; the scene above must match the one the checkpoint was written for
+    if (!restart_path.empty()) {
+        std::cout << "Loading checkpoint " << restart_path << std::endl;
+        if (auto snap = checkpoint::read(restart_path)) sim->restore(*snap);
     }
+    Checkpointer checkpointer(cfg.checkpoint);
+    ExportPipeline exporter(cfg.output);
+    StreamServer streamer(cfg.stream);
+    ProbeSet probes(cfg.probes, *sim);
+    if (probes.enabled()) sim->attachProbes(&probes);
 
-    // Add sources from config
-    if (!cfg.sources.empty()) {
-        std::cout << "Adding " << cfg.sources.size() << " sources" << std::endl;
-        for (auto &s : cfg.sources) {
-            sim.addSource(s);
+    if (headless) {
+        // Solver node without a window: results leave through checkpoints, exports and the stream
+        std::signal(SIGINT, requestStop);
+        std::signal(SIGTERM, requestStop);
+        const float color_range = static_cast<float>(cfg.vis.color_range);
+        auto headless_start = std::chrono::high_resolution_clock::now();
+        sim->step();
+        std::cout << "Running headless" << (sim->isTimeDomain() ? " to step " + std::to_string(cfg.max_steps) : "")
+                  << " - Ctrl+C to stop" << std::endl;
+        while (!stop_requested) {
+            if (sim->isTimeDomain()) {
+                if (sim->getStep() >= cfg.max_steps) break;
+                if (!sim->advance(std::min(cfg.steps_per_frame, cfg.max_steps - sim->getStep()))) break;  // Decomposed run failed
+                checkpointer.maybeSave(*sim);
+            } else if (!streamer.enabled()) {
+                break;  // A static field is complete after the first step
+            } else {
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));  // Keep serving late viewers
+            }
+            exporter.capture(*sim, color_range);
+            streamer.publish(*sim, color_range);
         }
-    }
-
-    // Add magnets from config
-    std::cout << "Adding " << cfg.magnets.size() << " configured magnets" << std::endl;
-    for (auto &m : cfg.magnets) {
-        sim.addMagnet(m);
+        const double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - headless_start).count();
+        std::cout << "Headless run finished at step " << sim->getStep() << " after " << std::fixed << std::setprecision(1)
+                  << seconds << " s" << std::defaultfloat << std::endl;
+        checkpointer.finish(*sim);
+        exporter.finish();
+        probes.finish();
+        streamer.stop();
+        return 0;
     }
 
     // Adaptive window sizing based on resolution
@@ -99,7 +223,7 @@ int main() {
     std::cout << "Raylib window initialized: " << window_width << "x" << window_height << std::endl;
     
     std::cout << "Initializing ultra-high resolution magnetic field renderer" << std::endl;
-    Renderer renderer(cfg.grid.nx, cfg.grid.ny, cfg.vis.color_range);
+    auto renderer = std::make_unique<Renderer>(sim->displayWidth(), sim->displayHeight(), cfg.vis.color_range);
     
     std::cout << "Creating ultra-detailed magnetic field pattern..." << std::endl;
     std::cout << "Scenario: " << cfg.scenario << std::endl;
@@ -107,6 +231,8 @@ int main() {
     std::cout << "  ????  UP/DOWN arrows = Adjust color range (coarse 0.05)" << std::endl;
     std::cout << "  ????  LEFT/RIGHT arrows = Fine-tune color range (0.02)" << std::endl;
     std::cout << "  ??  R = Reset color range to default" << std::endl;
+    std::cout << "  F = Toggle flux lines (static magnet fields)" << std::endl;
+    std::cout << "  Saving the config file applies the edit to the running view" << std::endl;
     std::cout << "  ?  ESC = Quit application" << std::endl;
     std::cout << "\n?? Ultra-High Resolution Color Legend:" << std::endl;
     std::cout << "  ?? Deep Blue/Purple = Very strong South pole field" << std::endl;
@@ -117,9 +243,14 @@ int main() {
     std::cout << "  ?? Orange = Strong North field" << std::endl;
     std::cout << "  ?? Red = Very strong North pole field" << std::endl;
 
+    // Flux lines need the Bx/By field, which is only kept while the overlay is wanted
+    FluxLines flux_lines(cfg.vis.flux_lines);
+    bool show_flux_lines = cfg.vis.flux_lines.show;
+    if (show_flux_lines) sim->keepVectorField(true);
+
     // Initialize the ultra-detailed magnetic field pattern
     std::cout << "\nComputing ultra-high resolution magnetic field..." << std::endl;
-    sim.step();
+    sim->step();
     
     auto end_time = std::chrono::high_resolution_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
@@ -128,8 +259,12 @@ int main() {
     std::cout << "\n?? Starting interactive ultra-high resolution magnetic field visualization!" << std::endl;
     std::cout << "?? Tip: Use UP/DOWN arrows to explore different field sensitivity levels" << std::endl;
 
-    // Variables for adjustable color bounds
-    const float default_color_range = static_cast<float>(cfg.vis.color_range);
+    // Variables for adjustable color bounds (R returns to the configured range, which hot reload may change)
+    float default_color_range = static_cast<float>(cfg.vis.color_range);
+    
+    // Edits to the config file are picked up while the window is open
+    ConfigWatcher watcher(config_path);
+    std::cout << "Watching " << config_path << " for changes" << std::endl;
     
     // Performance monitoring
     int frame_count = 0;
@@ -144,7 +279,7 @@ int main() {
             break;
         }
         
-        float current_range = static_cast<float>(renderer.getColorRange());
+        float current_range = static_cast<float>(renderer->getColorRange());
         bool range_changed = false;
         
         // Adjust color range with arrow keys
@@ -174,11 +309,93 @@ int main() {
         
         // Update renderer color range if changed
         if (range_changed) {
-            renderer.setColorRange(current_range);
+            renderer->setColorRange(current_range);
+        }
+        if (IsKeyPressed(KEY_F)) {
+            show_flux_lines = !show_flux_lines;
+            if (show_flux_lines) sim->keepVectorField(true);
+            std::cout << "Flux lines " << (show_flux_lines ? "on" : "off") << std::endl;
         }
         
+        // Config hot reload: only what the edit touched is redone
+        bool reloaded = false;
+        std::string reload_action;
+        double reload_apply_ms = 0.0;
+        if (auto next = watcher.poll()) {
+            applyOverrides(*next);
+            const ConfigDiff diff = diffConfig(cfg, *next);
+            if (diff.empty()) {
+                std::cout << "Config saved without changes" << std::endl;
+            } else {
+                auto apply_start = std::chrono::steady_clock::now();
+                std::cout << "Config changed: " << diff.summary() << std::endl;
+                const bool time_domain = !cfg.sources.empty() || !next->sources.empty();
+                reload_action = "settings";
+                if (diff.grid || diff.sources || (diff.materials && time_domain)) {
+                    // New solver and field; the old instance's probe nodes do not carry over
+                    reload_action = diff.grid ? "full rebuild" : "scene restart";
+                    if (probes.enabled()) std::cout << "Probes stop recording: the scene was rebuilt" << std::endl;
+                    sim = buildScene(*next);
+                    if (diff.grid) {
+                        renderer = std::make_unique<Renderer>(sim->displayWidth(), sim->displayHeight(), next->vis.color_range);
+                    }
+                    flux_lines.reconfigure(next->vis.flux_lines);
+                    if (diff.flux_lines) show_flux_lines = next->vis.flux_lines.show;
+                    if (show_flux_lines) sim->keepVectorField(true);
+                    checkpointer.restart();
+                    exporter.restart();
+                    sim->step();
+                } else {
+                    if (diff.materials) std::cout << "Materials do not affect the static magnet field" << std::endl;
+                    if (!diff.magnets.empty()) {
+                        // Static fields re-evaluate the windows around the edited magnets
+                        sim->setMagnets(next->magnets);
+                        if (!sim->isTimeDomain()) {
+                            reload_action = "local field update";
+                            sim->step();
+                        }
+                    }
+                    if (diff.flux_lines) {
+                        flux_lines.reconfigure(next->vis.flux_lines);
+                        show_flux_lines = next->vis.flux_lines.show;
+                        if (show_flux_lines) sim->keepVectorField(true);
+                    }
+                }
+                if (diff.color_range) {
+                    if (reload_action == "settings") reload_action = "colour table rebuild";
+                    renderer->setColorRange(next->vis.color_range);
+                    default_color_range = static_cast<float>(next->vis.color_range);
+                }
+                if (!diff.startup.empty()) {
+                    std::cout << "Checkpoint, export, stream and probe settings take effect on the next start" << std::endl;
+                }
+                cfg = *next;
+                reloaded = true;
+                reload_apply_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - apply_start).count();
+            }
+        }
+        
+        // Advance the time-domain solution (static magnet fields need no further steps)
+        if (sim->isTimeDomain()) {
+            sim->advance(std::min(cfg.steps_per_frame, cfg.max_steps - sim->getStep()));
+            checkpointer.maybeSave(*sim);
+        }
+        exporter.capture(*sim, static_cast<float>(renderer->getColorRange()));
+        streamer.publish(*sim, static_cast<float>(renderer->getColorRange()));
+        
+        // Flux lines are retraced only when the field changed (static fields recompute lazily in step())
+        if (show_flux_lines) {
+            if (!sim->isTimeDomain()) sim->step();
+            flux_lines.update(*sim);
+        }
+
         // Render the ultra-high resolution magnetic field
-        renderer.render(sim.getEz());
+        renderer->render(sim->getEz(), show_flux_lines && sim->hasVectorField() ? &flux_lines : nullptr);
+        if (reloaded) {
+            const double edit_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - watcher.modifiedAt()).count();
+            std::cout << "Config reload (" << reload_action << "): applied in " << std::fixed << std::setprecision(1)
+                      << reload_apply_ms << " ms, edit to display " << edit_ms << " ms" << std::defaultfloat << std::endl;
+        }
         
         // Performance monitoring
         frame_count++;
@@ -197,6 +414,10 @@ int main() {
 
     // Cleanup Raylib
     CloseWindow();
+    checkpointer.finish(*sim);
+    exporter.finish();
+    probes.finish();
+    streamer.stop();
     
     std::cout << "\n? Ultra-high resolution magnetic field simulation ended successfully!" << std::endl;
     std::cout << "?? Final Stats:" << std::endl;